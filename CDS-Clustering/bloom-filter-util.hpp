@@ -0,0 +1,92 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef BLOOMFILTERUTIL
+#define BLOOMFILTERUTIL
+
+#include "ns3/ndnSIM/ndn-cxx/bloom_filter.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief bloom_filter with write access to its bit table
+ *
+ * bloom_filter only hands out its table read-only. This wrapper starts from a filter of the
+ * wanted shape (size, salts) and overwrites the table, e.g. when loading a snapshot, or
+ * folds it for the aggregates of the supernode overlay.
+ */
+class MutableBloomFilter : public bloom_filter {
+public:
+  explicit MutableBloomFilter(const bloom_filter& shape)
+    : bloom_filter(shape)
+  {
+  }
+
+  size_t
+  GetTableBytes() const
+  {
+    return bit_table_.size();
+  }
+
+  /**
+   * @brief Replace the bit table
+   * @returns false (and leaves the filter unchanged) if bytes does not match the shape
+   */
+  bool
+  Assign(const uint8_t* table, size_t bytes, uint64_t elementCount)
+  {
+    if (bytes != bit_table_.size())
+      return false;
+
+    std::memcpy(&bit_table_[0], table, bytes);
+    inserted_element_count_ = elementCount;
+    return true;
+  }
+
+  /**
+   * @brief Halve the table by ORing its upper half into the lower one
+   *
+   * Bit i of an m-bit table lands on bit i mod m/2, which is where contains() of an m/2-bit
+   * filter looks for it, so the folded filter is queried as is: no false negatives, more
+   * false positives.
+   * @returns false (and leaves the filter unchanged) if the table bytes cannot be halved
+   */
+  bool
+  Fold()
+  {
+    size_t half = bit_table_.size() / 2;
+    if (half == 0 || bit_table_.size() % 2 != 0)
+      return false;
+
+    for (size_t i = 0; i < half; i++)
+      bit_table_[i] |= bit_table_[half + i];
+    bit_table_.resize(half);
+    table_size_ /= 2;
+    return true;
+  }
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif
@@ -0,0 +1,195 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "cluster-snapshot.hpp"
+#include "ns3/log.h"
+#include "ns3/node-list.h"
+
+#include "clusterc.hpp"
+#include "bloom-filter-util.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+NS_LOG_COMPONENT_DEFINE("ClusterSnapshot");
+
+namespace ns3 {
+namespace ndn {
+
+namespace {
+
+const char MAGIC[8] = {'C', 'L', 'U', 'S', 'N', 'A', 'P', '1'};
+const uint32_t NO_FILTER = std::numeric_limits<uint32_t>::max();
+
+struct SnapshotHeader
+{
+  char magic[8];
+  uint64_t topologyHash;
+  uint64_t filterBits;  // size() of every domain filter
+  uint32_t saltCount;
+  uint32_t nodes;
+  uint32_t filters;
+  uint32_t reserved;
+};
+
+struct SnapshotRecord
+{
+  uint32_t supernodeId;
+  uint32_t supernodeFace;
+  uint32_t filter; // index into the filter tables, NO_FILTER for members
+  uint32_t reserved;
+  uint64_t elementCount;
+};
+
+} // namespace
+
+bool
+ClusterSnapshot::Save(const std::string& fileName, uint64_t topologyHash)
+{
+  MutableBloomFilter shape(bloom_filter(PEC, FPP, UNIVERSAL_SEED));
+  size_t tableBytes = shape.GetTableBytes();
+
+  SnapshotHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.topologyHash = topologyHash;
+  header.filterBits = shape.size();
+  header.saltCount = shape.salt_count();
+  header.nodes = NodeList::GetNNodes();
+
+  std::vector<SnapshotRecord> records(header.nodes);
+  std::vector<const bloom_filter*> filters;
+  for (uint32_t i = 0; i < header.nodes; i++) {
+    SnapshotRecord& record = records[i];
+    std::memset(&record, 0, sizeof(record));
+    record.filter = NO_FILTER;
+
+    Ptr<Clusterconsumer> consumer = Clusterconsumer::GetClusterconsumer(NodeList::GetNode(i));
+    if (consumer == 0) {
+      NS_LOG_WARN("Node " << i << " has no Clusterconsumer");
+      return false;
+    }
+
+    record.supernodeId = consumer->GetSupernodeId();
+    record.supernodeFace = consumer->GetSupernodeFace();
+
+    const bloom_filter* filter = consumer->GetDomainFilter();
+    if (filter != 0) {
+      record.filter = filters.size();
+      record.elementCount = filter->element_count();
+      filters.push_back(filter);
+    }
+  }
+  header.filters = filters.size();
+
+  FILE* file = std::fopen(fileName.c_str(), "wb");
+  if (file == 0) {
+    NS_LOG_WARN("Cannot create snapshot " << fileName);
+    return false;
+  }
+
+  bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1
+            && std::fwrite(records.data(), sizeof(SnapshotRecord), records.size(), file) == records.size();
+  for (size_t i = 0; ok && i < filters.size(); i++)
+    ok = std::fwrite(filters[i]->table(), 1, tableBytes, file) == tableBytes;
+  ok = std::fclose(file) == 0 && ok;
+
+  NS_LOG_INFO("Saved " << header.nodes << " nodes and " << header.filters << " domain filters to "
+              << fileName);
+  return ok;
+}
+
+bool
+ClusterSnapshot::Load(const std::string& fileName, uint64_t topologyHash)
+{
+  int fd = open(fileName.c_str(), O_RDONLY);
+  if (fd < 0) {
+    NS_LOG_WARN("Cannot open snapshot " << fileName);
+    return false;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(SnapshotHeader)) {
+    close(fd);
+    return false;
+  }
+
+  size_t length = st.st_size;
+  void* mapping = mmap(0, length, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    NS_LOG_WARN("Cannot map snapshot " << fileName);
+    return false;
+  }
+
+  const uint8_t* base = static_cast<const uint8_t*>(mapping);
+  const SnapshotHeader* header = reinterpret_cast<const SnapshotHeader*>(base);
+  const SnapshotRecord* records = reinterpret_cast<const SnapshotRecord*>(base + sizeof(SnapshotHeader));
+  const uint8_t* tables = base + sizeof(SnapshotHeader) + header->nodes * sizeof(SnapshotRecord);
+
+  MutableBloomFilter shape(bloom_filter(PEC, FPP, UNIVERSAL_SEED));
+  size_t tableBytes = shape.GetTableBytes();
+
+  bool valid = std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) == 0
+               && header->topologyHash == topologyHash
+               && header->nodes == NodeList::GetNNodes()
+               && header->filterBits == shape.size()
+               && header->saltCount == shape.salt_count()
+               && length == sizeof(SnapshotHeader) + header->nodes * sizeof(SnapshotRecord)
+                              + header->filters * tableBytes;
+
+  // check everything before warm-starting the first node
+  for (uint32_t i = 0; valid && i < header->nodes; i++) {
+    valid = (records[i].filter == NO_FILTER || records[i].filter < header->filters)
+            && Clusterconsumer::GetClusterconsumer(NodeList::GetNode(i)) != 0;
+  }
+
+  if (!valid) {
+    NS_LOG_WARN("Snapshot " << fileName << " does not match this topology");
+    munmap(mapping, length);
+    return false;
+  }
+
+  for (uint32_t i = 0; i < header->nodes; i++) {
+    const SnapshotRecord& record = records[i];
+    Ptr<Clusterconsumer> consumer = Clusterconsumer::GetClusterconsumer(NodeList::GetNode(i));
+
+    if (record.filter == NO_FILTER) {
+      consumer->WarmStart(record.supernodeId, record.supernodeFace, 0);
+    }
+    else {
+      MutableBloomFilter filter(shape);
+      filter.Assign(tables + record.filter * tableBytes, tableBytes, record.elementCount);
+      consumer->WarmStart(record.supernodeId, record.supernodeFace, &filter);
+    }
+  }
+
+  NS_LOG_INFO("Warm-started " << header->nodes << " nodes from " << fileName);
+  munmap(mapping, length);
+  return true;
+}
+
+} // namespace ndn
+} // namespace ns3
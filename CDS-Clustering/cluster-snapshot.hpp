@@ -0,0 +1,61 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef CLUSTERSNAPSHOT
+#define CLUSTERSNAPSHOT
+
+#include <cstdint>
+#include <string>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief Converged clustering state of all nodes, saved to and loaded from a file
+ *
+ * The file holds a fixed header, one record per node (role, supernode id and face) and the
+ * raw domain filter tables of all supernodes. Loading maps the file read-only and hands
+ * every node its record through Clusterconsumer::WarmStart, so the election and the filter
+ * build-up are skipped entirely.
+ *
+ * A snapshot is only valid for the topology it was taken on: the caller passes a hash of
+ * the topology (e.g. ClusterGraph::GetHash()) which is stored in the header and checked
+ * on load.
+ */
+class ClusterSnapshot {
+public:
+  /**
+   * @brief Write the state of all nodes in the NodeList
+   */
+  static bool
+  Save(const std::string& fileName, uint64_t topologyHash);
+
+  /**
+   * @brief Warm-start all nodes in the NodeList, before the simulation runs
+   * @returns false if the file is missing, malformed or taken on another topology, in
+   *          which case no node has been touched
+   */
+  static bool
+  Load(const std::string& fileName, uint64_t topologyHash);
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif
@@ -0,0 +1,82 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef FILTERTRUST
+#define FILTERTRUST
+
+#include "ns3/nstime.h"
+
+#include <cstdint>
+#include <map>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief False positive rates of the supernode filters a node forwards on, as observed
+ *
+ * Every request sent to a supernode because its filter matched is one sample of that
+ * filter: a Data is a hit, a Nack or a timeout a false positive. The rate is an exponential
+ * moving average of the samples. Until a filter has MIN_SAMPLES of them, the rate its own
+ * fill predicts stands in. A filter whose rate exceeds the noisy rate is due for a rebuild,
+ * asked for at most once per hold-down; its samples start over afterwards.
+ */
+class FilterTrust {
+public:
+  static const uint32_t MIN_SAMPLES = 10;
+
+  /**
+   * @param noisyRate false positive rate above which a rebuild is asked for, 0 never
+   * @param holdDown between two rebuild requests to the same supernode
+   */
+  explicit FilterTrust(double noisyRate = 0.2, Time holdDown = Seconds(30));
+
+  void
+  Record(uint32_t supernodeId, bool falsePositive);
+
+  /**
+   * @param predicted false positive rate of the filter from its fill
+   */
+  double
+  GetRate(uint32_t supernodeId, double predicted) const;
+
+  /**
+   * @brief Whether to ask the supernode for a rebuild now; if so, it is noted as asked
+   */
+  bool
+  ShouldRebuild(uint32_t supernodeId, Time now);
+
+private:
+  struct Source
+  {
+    double rate = 0.0;
+    uint32_t samples = 0;
+    bool asked = false;
+    Time askedAt;
+  };
+
+  double m_noisyRate;
+  Time m_holdDown;
+  std::map<uint32_t, Source> m_sources;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif
@@ -0,0 +1,168 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "member-filter-table.hpp"
+
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace ns3 {
+namespace ndn {
+
+MemberFilterTable::MemberFilterTable(const bloom_filter& shape)
+  : m_bytes(shape.size() / 8)
+  , m_leaves(1)
+  , m_arena(2 * m_bytes, 0)
+  , m_dirty(2, false)
+  , m_freeSlots(1, 0)
+  , m_elements(0)
+{
+}
+
+bool
+MemberFilterTable::Update(uint32_t memberId, const bloom_filter& filter, Time now)
+{
+  if (filter.size() / 8 != m_bytes)
+    return false;
+
+  auto member = m_members.find(memberId);
+  if (member == m_members.end()) {
+    if (m_freeSlots.empty())
+      Grow();
+    member = m_members.emplace(memberId, Member{m_freeSlots.back(), 0, now}).first;
+    m_freeSlots.pop_back();
+  }
+
+  uint8_t* leaf = GetNode(m_leaves + member->second.slot);
+  if (std::memcmp(leaf, filter.table(), m_bytes) != 0) {
+    std::memcpy(leaf, filter.table(), m_bytes);
+    MarkPath(member->second.slot);
+  }
+  m_elements += filter.element_count() - member->second.elements;
+  member->second.elements = filter.element_count();
+  member->second.updated = now;
+  return true;
+}
+
+bool
+MemberFilterTable::Remove(uint32_t memberId)
+{
+  auto member = m_members.find(memberId);
+  if (member == m_members.end())
+    return false;
+
+  std::memset(GetNode(m_leaves + member->second.slot), 0, m_bytes);
+  MarkPath(member->second.slot);
+  m_elements -= member->second.elements;
+  m_freeSlots.push_back(member->second.slot);
+  m_members.erase(member);
+  return true;
+}
+
+size_t
+MemberFilterTable::Expire(Time since)
+{
+  std::vector<uint32_t> expired;
+  for (const auto& member : m_members) {
+    if (member.second.updated < since)
+      expired.push_back(member.first);
+  }
+  for (uint32_t memberId : expired)
+    Remove(memberId);
+  return expired.size();
+}
+
+size_t
+MemberFilterTable::GetSize() const
+{
+  return m_members.size();
+}
+
+size_t
+MemberFilterTable::GetTableBytes() const
+{
+  return m_bytes;
+}
+
+uint64_t
+MemberFilterTable::GetElementCount() const
+{
+  return m_elements;
+}
+
+const uint8_t*
+MemberFilterTable::GetAggregate()
+{
+  // children before parents
+  for (size_t node = m_leaves - 1; node >= 1; node--) {
+    if (!m_dirty[node])
+      continue;
+    Or(GetNode(node), GetNode(2 * node), GetNode(2 * node + 1), m_bytes);
+    m_dirty[node] = false;
+  }
+  return GetNode(1);
+}
+
+void
+MemberFilterTable::Or(uint8_t* dst, const uint8_t* a, const uint8_t* b, size_t bytes)
+{
+  size_t i = 0;
+#ifdef __SSE2__
+  for (; i + 16 <= bytes; i += 16) {
+    __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+    __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_or_si128(x, y));
+  }
+#endif
+  for (; i < bytes; i++)
+    dst[i] = a[i] | b[i];
+}
+
+uint8_t*
+MemberFilterTable::GetNode(size_t node)
+{
+  return &m_arena[node * m_bytes];
+}
+
+void
+MemberFilterTable::MarkPath(size_t slot)
+{
+  for (size_t node = (m_leaves + slot) / 2; node >= 1; node /= 2)
+    m_dirty[node] = true;
+}
+
+void
+MemberFilterTable::Grow()
+{
+  // the leaves move up a level, every inner node is recomputed on the next GetAggregate
+  size_t leaves = 2 * m_leaves;
+  std::vector<uint8_t> arena(2 * leaves * m_bytes, 0);
+  std::memcpy(&arena[leaves * m_bytes], &m_arena[m_leaves * m_bytes], m_leaves * m_bytes);
+  m_arena.swap(arena);
+  m_dirty.assign(2 * leaves, true);
+  for (size_t slot = leaves - 1; slot >= m_leaves; slot--)
+    m_freeSlots.push_back(slot);
+  m_leaves = leaves;
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,124 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef MEMBERFILTERTABLE
+#define MEMBERFILTERTABLE
+
+#include "ns3/ndnSIM/ndn-cxx/bloom_filter.hpp"
+#include "ns3/nstime.h"
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief The filter of every member of a domain, and their OR
+ *
+ * The member tables sit in one arena as the leaves of a binary OR tree: node i at
+ * i * table bytes, its children at 2i and 2i + 1, the leaves from the first power of two
+ * at or above the number of slots, the aggregate at node 1. Update and Remove only rewrite
+ * a leaf and mark the path above it, GetAggregate then ORs just the marked nodes, so a
+ * member change costs O(log members) table ORs however many changes it batches, and a
+ * member that leaves takes exactly its own bits along.
+ */
+class MemberFilterTable {
+public:
+  /**
+   * @param shape filter whose size the member filters must have
+   */
+  explicit MemberFilterTable(const bloom_filter& shape);
+
+  /**
+   * @brief Store a member's filter in place of its previous one
+   * @returns false (and leaves the table unchanged) if the filter has another size
+   */
+  bool
+  Update(uint32_t memberId, const bloom_filter& filter, Time now);
+
+  /**
+   * @returns false if the member has no filter in the table
+   */
+  bool
+  Remove(uint32_t memberId);
+
+  /**
+   * @brief Remove the members whose filter was last updated before since
+   * @returns the number of members removed
+   */
+  size_t
+  Expire(Time since);
+
+  size_t
+  GetSize() const;
+
+  size_t
+  GetTableBytes() const;
+
+  /**
+   * @brief Sum of the members' element counts, an upper bound for the aggregate
+   */
+  uint64_t
+  GetElementCount() const;
+
+  /**
+   * @brief OR of all member tables, GetTableBytes() long
+   */
+  const uint8_t*
+  GetAggregate();
+
+  /**
+   * @brief dst = a | b over bytes, 16 bytes at a time where SSE2 is available
+   */
+  static void
+  Or(uint8_t* dst, const uint8_t* a, const uint8_t* b, size_t bytes);
+
+private:
+  uint8_t*
+  GetNode(size_t node);
+
+  void
+  MarkPath(size_t slot);
+
+  void
+  Grow();
+
+private:
+  struct Member
+  {
+    size_t slot;
+    uint64_t elements;
+    Time updated;
+  };
+
+  size_t m_bytes;                  // of one table
+  size_t m_leaves;                 // power of two
+  std::vector<uint8_t> m_arena;    // 2 * m_leaves tables, node 0 unused
+  std::vector<bool> m_dirty;       // inner nodes below which a leaf changed
+  std::vector<size_t> m_freeSlots;
+  std::map<uint32_t, Member> m_members;
+  uint64_t m_elements;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif
@@ -0,0 +1,196 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "neighbourhood.hpp"
+
+#include <algorithm>
+
+namespace ns3 {
+namespace ndn {
+
+namespace {
+
+// unsigned LEB128: 7 bits per byte, least significant group first
+void
+PutVarint(::ndn::Buffer& buffer, uint32_t value)
+{
+  while (value >= 0x80) {
+    buffer.push_back(static_cast<uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  buffer.push_back(static_cast<uint8_t>(value));
+}
+
+bool
+GetVarint(const uint8_t*& p, const uint8_t* end, uint32_t& value)
+{
+  value = 0;
+  for (int shift = 0; shift < 35 && p != end; shift += 7) {
+    uint8_t byte = *p++;
+    value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0)
+      return shift < 28 || byte < 0x10; // no bits beyond 32
+  }
+  return false;
+}
+
+} // namespace
+
+const uint32_t NeighbourhoodInfo::UNKNOWN;
+
+NeighbourhoodInfo::NeighbourhoodInfo()
+  : supernodeId(UNKNOWN)
+  , backupId(UNKNOWN)
+  , flags(0)
+  , span(UNKNOWN)
+  , score(0)
+  , domainSize(0)
+{
+}
+
+bool
+NeighbourhoodInfo::IsNeighbour(uint32_t nodeId) const
+{
+  return std::binary_search(neighbours.begin(), neighbours.end(), nodeId);
+}
+
+shared_ptr< ::ndn::Buffer>
+NeighbourhoodInfo::Encode() const
+{
+  auto buffer = make_shared< ::ndn::Buffer>();
+  buffer->reserve(16 + neighbours.size());
+
+  // UNKNOWN wraps around to 0, the shortest encoding
+  PutVarint(*buffer, supernodeId + 1);
+  PutVarint(*buffer, flags);
+  PutVarint(*buffer, span + 1);
+  PutVarint(*buffer, neighbours.size());
+
+  uint32_t previous = 0;
+  for (size_t i = 0; i < neighbours.size(); i++) {
+    PutVarint(*buffer, i == 0 ? neighbours[i] : neighbours[i] - previous - 1);
+    previous = neighbours[i];
+  }
+
+  PutVarint(*buffer, supernodes.size());
+  for (size_t i = 0; i < supernodes.size(); i++) {
+    PutVarint(*buffer, i == 0 ? supernodes[i].first : supernodes[i].first - previous - 1);
+    PutVarint(*buffer, supernodes[i].second);
+    previous = supernodes[i].first;
+  }
+
+  PutVarint(*buffer, candidates.size());
+  for (const Candidate& candidate : candidates) {
+    PutVarint(*buffer, candidate.first);
+    PutVarint(*buffer, candidate.second);
+  }
+
+  PutVarint(*buffer, overlay.size());
+  for (const OverlayEntry& entry : overlay) {
+    PutVarint(*buffer, entry.level);
+    PutVarint(*buffer, entry.supernodeId);
+    PutVarint(*buffer, entry.distance);
+    PutVarint(*buffer, entry.span + 1);
+    PutVarint(*buffer, entry.parent + 1);
+  }
+
+  PutVarint(*buffer, backupId + 1);
+  PutVarint(*buffer, score);
+  PutVarint(*buffer, domainSize);
+
+  return buffer;
+}
+
+bool
+NeighbourhoodInfo::Decode(const uint8_t* buffer, size_t length)
+{
+  const uint8_t* p = buffer;
+  const uint8_t* end = buffer + length;
+
+  uint32_t count;
+  if (!GetVarint(p, end, supernodeId) || !GetVarint(p, end, flags) || !GetVarint(p, end, span)
+      || !GetVarint(p, end, count))
+    return false;
+  supernodeId--;
+  span--;
+
+  // every neighbour takes at least one byte, which also bounds the allocation
+  if (count > static_cast<size_t>(end - p))
+    return false;
+
+  neighbours.resize(count);
+  uint64_t next = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    uint32_t gap;
+    if (!GetVarint(p, end, gap))
+      return false;
+    next += gap;
+    if (next > std::numeric_limits<uint32_t>::max())
+      return false;
+    neighbours[i] = next++;
+  }
+
+  // supernodes and candidates take at least two bytes each
+  if (!GetVarint(p, end, count) || count > static_cast<size_t>(end - p) / 2)
+    return false;
+
+  supernodes.resize(count);
+  next = 0;
+  for (uint32_t i = 0; i < count; i++) {
+    uint32_t gap;
+    if (!GetVarint(p, end, gap) || !GetVarint(p, end, supernodes[i].second))
+      return false;
+    next += gap;
+    if (next > std::numeric_limits<uint32_t>::max())
+      return false;
+    supernodes[i].first = next++;
+  }
+
+  if (!GetVarint(p, end, count) || count > static_cast<size_t>(end - p) / 2)
+    return false;
+
+  candidates.resize(count);
+  for (uint32_t i = 0; i < count; i++) {
+    if (!GetVarint(p, end, candidates[i].first) || !GetVarint(p, end, candidates[i].second))
+      return false;
+  }
+
+  if (!GetVarint(p, end, count) || count > static_cast<size_t>(end - p) / 5)
+    return false;
+
+  overlay.resize(count);
+  for (OverlayEntry& entry : overlay) {
+    if (!GetVarint(p, end, entry.level) || !GetVarint(p, end, entry.supernodeId)
+        || !GetVarint(p, end, entry.distance) || !GetVarint(p, end, entry.span)
+        || !GetVarint(p, end, entry.parent))
+      return false;
+    entry.span--;
+    entry.parent--;
+  }
+
+  if (!GetVarint(p, end, backupId) || !GetVarint(p, end, score)
+      || !GetVarint(p, end, domainSize))
+    return false;
+  backupId--;
+
+  return p == end;
+}
+
+} // namespace ndn
+} // namespace ns3
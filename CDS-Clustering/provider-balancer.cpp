@@ -0,0 +1,149 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "provider-balancer.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+namespace {
+
+const uint32_t MAX_FAILURES = 3;
+
+} // namespace
+
+ProviderBalancer::ProviderBalancer(uint32_t maxInFlight, Time retireTime)
+  : m_maxInFlight(maxInFlight)
+  , m_retireTime(retireTime)
+{
+}
+
+std::vector<uint32_t>
+ProviderBalancer::GetActive(const std::vector<uint32_t>& candidates, Time now) const
+{
+  std::vector<uint32_t> active;
+  for (uint32_t face : candidates) {
+    if (!IsRetired(face, now))
+      active.push_back(face);
+  }
+  if (active.empty())
+    active = candidates; // all overloaded, the least loaded of them still has to serve
+  return active;
+}
+
+uint32_t
+ProviderBalancer::Choose(const std::vector<uint32_t>& active, size_t first, size_t second) const
+{
+  double rttSum = 0.0;
+  uint32_t rtts = 0;
+  for (uint32_t face : active) {
+    auto provider = m_providers.find(face);
+    if (provider != m_providers.end() && provider->second.hasRtt) {
+      rttSum += provider->second.srtt.GetSeconds();
+      rtts++;
+    }
+  }
+  double meanRtt = rtts > 0 ? rttSum / rtts : 1.0;
+
+  return GetCost(active[first], meanRtt) <= GetCost(active[second], meanRtt) ? active[first]
+                                                                             : active[second];
+}
+
+Time
+ProviderBalancer::GetTimeout(uint32_t face) const
+{
+  auto provider = m_providers.find(face);
+  if (provider == m_providers.end() || !provider->second.hasRtt)
+    return Time();
+  return provider->second.srtt + provider->second.srtt;
+}
+
+bool
+ProviderBalancer::Sent(uint32_t face, Time now)
+{
+  Provider& provider = m_providers[face];
+  provider.inFlight++;
+  if (m_maxInFlight == 0 || provider.inFlight <= m_maxInFlight || now < provider.retiredUntil)
+    return false;
+
+  Retire(provider, now);
+  return true;
+}
+
+void
+ProviderBalancer::Answered(uint32_t face, Time rtt)
+{
+  Provider& provider = m_providers[face];
+  if (provider.inFlight > 0)
+    provider.inFlight--;
+  provider.failures = 0;
+  provider.srtt =
+    provider.hasRtt ? provider.srtt + NanoSeconds((rtt - provider.srtt).GetNanoSeconds() / 8) : rtt;
+  provider.hasRtt = true;
+}
+
+bool
+ProviderBalancer::Failed(uint32_t face, bool congestion, Time now)
+{
+  Provider& provider = m_providers[face];
+  if (provider.inFlight > 0)
+    provider.inFlight--;
+  provider.failures++;
+  if (!congestion && provider.failures < MAX_FAILURES)
+    return false;
+
+  Retire(provider, now);
+  return true;
+}
+
+void
+ProviderBalancer::Cancelled(uint32_t face)
+{
+  auto provider = m_providers.find(face);
+  if (provider != m_providers.end() && provider->second.inFlight > 0)
+    provider->second.inFlight--;
+}
+
+bool
+ProviderBalancer::IsRetired(uint32_t face, Time now) const
+{
+  auto provider = m_providers.find(face);
+  return provider != m_providers.end() && now < provider->second.retiredUntil;
+}
+
+void
+ProviderBalancer::Retire(Provider& provider, Time now)
+{
+  provider.retiredUntil = now + m_retireTime;
+  provider.failures = 0;
+}
+
+double
+ProviderBalancer::GetCost(uint32_t face, double meanRtt) const
+{
+  auto provider = m_providers.find(face);
+  if (provider == m_providers.end())
+    return meanRtt;
+
+  double rtt = provider->second.hasRtt ? provider->second.srtt.GetSeconds() : meanRtt;
+  return rtt * (provider->second.inFlight + 1);
+}
+
+} // namespace ndn
+} // namespace ns3
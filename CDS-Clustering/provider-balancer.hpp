@@ -0,0 +1,142 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef PROVIDERBALANCER
+#define PROVIDERBALANCER
+
+#include "ns3/nstime.h"
+
+#include <cstdint>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief Load and RTT estimates of the faces a supernode sends service requests to, and the
+ *        power-of-two-choices pick among them
+ *
+ * A face is a provider: a member whose service filter matched, or an adjacent domain. Its
+ * load is the number of requests in flight on it, its RTT a smoothed average of the Data it
+ * returned (weight 1/8, as TCP's SRTT). Pick draws two of the candidates that are not retired
+ * and keeps the one with the lower expected wait, SRTT * (in flight + 1); a face without an
+ * RTT yet is taken at the mean of the others, so new providers get their share.
+ *
+ * A face with more than maxInFlight requests in flight, a congestion Nack or three failures
+ * in a row (Nacks, timeouts) is overloaded and retired for retireTime: Pick passes it over
+ * while there are others.
+ */
+class ProviderBalancer {
+public:
+  explicit ProviderBalancer(uint32_t maxInFlight = 8, Time retireTime = MilliSeconds(1000));
+
+  /**
+   * @brief Choose one of candidates, 0 if there are none
+   * @param candidates faces, of any integer type (NFD's FaceId)
+   * @param rng any uniform random bit generator, e.g. NFD's getGlobalRng()
+   */
+  template<typename Face, typename Rng>
+  Face
+  Pick(const std::vector<Face>& candidates, Time now, Rng& rng) const
+  {
+    std::vector<uint32_t> active = GetActive(std::vector<uint32_t>(candidates.begin(),
+                                                                    candidates.end()), now);
+    if (active.size() < 2)
+      return active.empty() ? 0 : active.front();
+
+    std::uniform_int_distribution<size_t> dist(0, active.size() - 1);
+    size_t first = dist(rng);
+    size_t second = dist(rng);
+    while (second == first)
+      second = dist(rng);
+    return Choose(active, first, second);
+  }
+
+  /**
+   * @brief Time after which a request on face is better given up on: twice its SRTT, zero
+   *        while it has no RTT yet
+   */
+  Time
+  GetTimeout(uint32_t face) const;
+
+  /**
+   * @returns true if this retired the face
+   */
+  bool
+  Sent(uint32_t face, Time now);
+
+  void
+  Answered(uint32_t face, Time rtt);
+
+  /**
+   * @brief A request on face got no Data: a Nack, a timeout, or congestion
+   * @returns true if this retired the face
+   */
+  bool
+  Failed(uint32_t face, bool congestion, Time now);
+
+  /**
+   * @brief A request on face was answered by another face, it is no longer in flight
+   */
+  void
+  Cancelled(uint32_t face);
+
+  bool
+  IsRetired(uint32_t face, Time now) const;
+
+private:
+  struct Provider
+  {
+    uint32_t inFlight = 0;
+    uint32_t failures = 0; // in a row
+    bool hasRtt = false;
+    Time srtt;
+    Time retiredUntil;
+  };
+
+  void
+  Retire(Provider& provider, Time now);
+
+  /**
+   * @brief The candidates that are not retired, or all of them if every one is
+   */
+  std::vector<uint32_t>
+  GetActive(const std::vector<uint32_t>& candidates, Time now) const;
+
+  /**
+   * @brief The cheaper of active[first] and active[second]
+   */
+  uint32_t
+  Choose(const std::vector<uint32_t>& active, size_t first, size_t second) const;
+
+  double
+  GetCost(uint32_t face, double meanRtt) const;
+
+private:
+  uint32_t m_maxInFlight;
+  Time m_retireTime;
+  std::map<uint32_t, Provider> m_providers;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif
@@ -0,0 +1,193 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "resolution-cache.hpp"
+
+#include <functional>
+#include <limits>
+
+namespace ns3 {
+namespace ndn {
+
+namespace {
+
+const size_t NPOS = std::numeric_limits<size_t>::max();
+
+} // namespace
+
+ResolutionCache::ResolutionCache(size_t capacity)
+  : m_capacity(capacity)
+  , m_size(0)
+  , m_hand(0)
+{
+  size_t slots = 1;
+  while (slots < 2 * capacity)
+    slots <<= 1;
+  m_slots.assign(capacity > 0 ? slots : 0, Entry());
+  for (Entry& entry : m_slots)
+    entry.used = false;
+}
+
+const ResolutionCache::Entry*
+ResolutionCache::Find(const Name& service, Time now)
+{
+  if (m_size == 0)
+    return 0;
+
+  size_t slot = Lookup(Hash(service));
+  if (slot == NPOS)
+    return 0;
+
+  Entry& entry = m_slots[slot];
+  if (entry.expiry <= now) {
+    EraseSlot(slot);
+    return 0;
+  }
+  entry.referenced = true;
+  return &entry;
+}
+
+void
+ResolutionCache::InsertPositive(const Name& service, uint32_t face, Time latency, Time expiry)
+{
+  if (m_capacity == 0)
+    return;
+
+  Entry& entry = Insert(Hash(service));
+  entry.face = face;
+  entry.latency = latency;
+  entry.expiry = expiry;
+  entry.negative = false;
+}
+
+void
+ResolutionCache::InsertNegative(const Name& service, Time expiry)
+{
+  if (m_capacity == 0)
+    return;
+
+  Entry& entry = Insert(Hash(service));
+  entry.face = 0;
+  entry.latency = Time();
+  entry.expiry = expiry;
+  entry.negative = true;
+}
+
+void
+ResolutionCache::Erase(const Name& service)
+{
+  if (m_size == 0)
+    return;
+
+  size_t slot = Lookup(Hash(service));
+  if (slot != NPOS)
+    EraseSlot(slot);
+}
+
+size_t
+ResolutionCache::GetSize() const
+{
+  return m_size;
+}
+
+size_t
+ResolutionCache::GetCapacity() const
+{
+  return m_capacity;
+}
+
+size_t
+ResolutionCache::Lookup(uint64_t key) const
+{
+  size_t mask = m_slots.size() - 1;
+  for (size_t slot = key & mask; m_slots[slot].used; slot = (slot + 1) & mask) {
+    if (m_slots[slot].key == key)
+      return slot;
+  }
+  return NPOS;
+}
+
+ResolutionCache::Entry&
+ResolutionCache::Insert(uint64_t key)
+{
+  size_t slot = Lookup(key);
+  if (slot != NPOS)
+    return m_slots[slot];
+
+  if (m_size >= m_capacity)
+    Evict();
+
+  size_t mask = m_slots.size() - 1;
+  for (slot = key & mask; m_slots[slot].used; slot = (slot + 1) & mask)
+    ;
+
+  Entry& entry = m_slots[slot];
+  entry.key = key;
+  entry.referenced = false;
+  entry.used = true;
+  m_size++;
+  return entry;
+}
+
+void
+ResolutionCache::Evict()
+{
+  // terminates within two sweeps: the first clears every reference bit
+  size_t mask = m_slots.size() - 1;
+  for (;;) {
+    size_t slot = m_hand;
+    m_hand = (m_hand + 1) & mask;
+
+    Entry& entry = m_slots[slot];
+    if (!entry.used)
+      continue;
+    if (entry.referenced) {
+      entry.referenced = false;
+      continue;
+    }
+    EraseSlot(slot);
+    return;
+  }
+}
+
+void
+ResolutionCache::EraseSlot(size_t slot)
+{
+  // backward shift: pull later entries of the probe run into the hole, no tombstones
+  size_t mask = m_slots.size() - 1;
+  size_t hole = slot;
+  for (size_t next = (hole + 1) & mask; m_slots[next].used; next = (next + 1) & mask) {
+    size_t home = m_slots[next].key & mask;
+    if (((next - home) & mask) >= ((next - hole) & mask)) {
+      m_slots[hole] = m_slots[next];
+      hole = next;
+    }
+  }
+  m_slots[hole].used = false;
+  m_size--;
+}
+
+uint64_t
+ResolutionCache::Hash(const Name& service)
+{
+  return std::hash<Name>()(service);
+}
+
+} // namespace ndn
+} // namespace ns3
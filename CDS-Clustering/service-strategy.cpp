@@ -0,0 +1,745 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "service-strategy.hpp"
+#include "clusterc.hpp"
+#include "sharded-filter.hpp"
+
+#include "fw/algorithm.hpp"
+#include "fw/strategy-info.hpp"
+#include "core/logger.hpp"
+#include "core/random.hpp"
+#include "core/scheduler.hpp"
+
+#include "ns3/node-list.h"
+#include "ns3/simulator.h"
+
+#include <ndn-cxx/lp/tags.hpp>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <tuple>
+
+namespace nfd {
+namespace fw {
+
+NFD_LOG_INIT("ServiceStrategy");
+NFD_REGISTER_STRATEGY(ServiceStrategy);
+
+namespace {
+
+/**
+ * @brief Start of a request on the node it was issued on
+ */
+class ResolutionInfo : public StrategyInfo {
+public:
+  static constexpr int
+  getTypeId()
+  {
+    return 9100;
+  }
+
+  explicit ResolutionInfo(ns3::Time start)
+    : start(start)
+  {
+  }
+
+  ns3::Time start;
+};
+
+/**
+ * @brief Start of a request at a caching supernode, and the cache entry it was sent by
+ */
+class LookupInfo : public StrategyInfo {
+public:
+  static constexpr int
+  getTypeId()
+  {
+    return 9102;
+  }
+
+  explicit LookupInfo(ns3::Time start)
+    : start(start)
+    , cached(false)
+  {
+  }
+
+  ns3::Time start;
+  bool cached;
+  ns3::Time cachedLatency;
+};
+
+/**
+ * @brief Supernodes a request was sent to on their filters, by face, until they answer
+ *
+ * Those that have not when the PIT entry goes away timed out.
+ */
+class ProbeInfo : public StrategyInfo {
+public:
+  static constexpr int
+  getTypeId()
+  {
+    return 9103;
+  }
+
+  explicit ProbeInfo(std::weak_ptr<ns3::ndn::FilterTrust> trust)
+    : trust(trust)
+  {
+  }
+
+  ~ProbeInfo()
+  {
+    std::shared_ptr<ns3::ndn::FilterTrust> filterTrust = trust.lock();
+    if (filterTrust == nullptr)
+      return;
+
+    for (const auto& probe : pending) {
+      filterTrust->Record(probe.second, true);
+      ServiceStrategy::GetProbeTrace()(ns3::Simulator::GetContext(), probe.second, true);
+    }
+  }
+
+  std::weak_ptr<ns3::ndn::FilterTrust> trust;
+  std::map<FaceId, uint32_t> pending;
+};
+
+/**
+ * @brief Faces a request is in flight on, for ProviderBalancer; those still in flight when the
+ *        PIT entry goes away timed out
+ */
+class BalanceInfo : public StrategyInfo {
+public:
+  static constexpr int
+  getTypeId()
+  {
+    return 9104;
+  }
+
+  explicit BalanceInfo(std::weak_ptr<ns3::ndn::ProviderBalancer> balancer)
+    : balancer(balancer)
+  {
+  }
+
+  ~BalanceInfo()
+  {
+    std::shared_ptr<ns3::ndn::ProviderBalancer> providerBalancer = balancer.lock();
+    if (providerBalancer == nullptr)
+      return;
+
+    for (FaceId face : inFlight) {
+      if (providerBalancer->Failed(face, false, ns3::Simulator::Now()))
+        ServiceStrategy::GetRetireTrace()(ns3::Simulator::GetContext(), face);
+    }
+  }
+
+  std::weak_ptr<ns3::ndn::ProviderBalancer> balancer;
+  std::set<FaceId> inFlight;
+};
+
+/**
+ * @brief Candidates of a request not asked yet
+ */
+class HedgeInfo : public StrategyInfo {
+public:
+  static constexpr int
+  getTypeId()
+  {
+    return 9101;
+  }
+
+  std::vector<FaceId> pending;
+  scheduler::ScopedEventId event; // cancelled with the PIT entry
+};
+
+// longest prefix first: the service name may be followed by request parameters
+size_t
+MatchLength(const bloom_filter& filter, const Name& name)
+{
+  for (size_t length = name.size(); length > 0; length--) {
+    if (filter.contains(name.getPrefix(length).toUri()))
+      return length;
+  }
+  return 0;
+}
+
+bool
+Matches(const bloom_filter& filter, const Name& name)
+{
+  return MatchLength(filter, name) > 0;
+}
+
+// the shard of the name if the supernode sent it, else its whole IIM filter; fpp is the
+// predicted false positive rate of the filter that matched
+size_t
+MatchLength(const ns3::ndn::Clusterconsumer::SupernodeFilter& entry, const Name& name, double& fpp)
+{
+  auto shard = entry.shards.find(ns3::ndn::ShardedFilter::GetShard(name));
+  if (shard != entry.shards.end()) {
+    size_t length = MatchLength(shard->second, name);
+    if (length > 0) {
+      fpp = ns3::ndn::ShardedFilter::GetFpp(shard->second);
+      return length;
+    }
+  }
+
+  // a member's entry has no whole filter
+  if (entry.filter.size() == 0)
+    return 0;
+  fpp = entry.filter.effective_fpp();
+  return MatchLength(entry.filter, name);
+}
+
+bool
+Matches(const ns3::ndn::Clusterconsumer::SupernodeFilter& entry, const Name& name)
+{
+  double fpp;
+  return MatchLength(entry, name, fpp) > 0;
+}
+
+// the supernode whose filter a request was sent on, by the face it was sent to
+uint32_t
+FindSupernode(ns3::Ptr<ns3::ndn::Clusterconsumer> consumer, FaceId face)
+{
+  for (const auto& entry : consumer->GetSupernodeFilters()) {
+    if (entry.second.face == face)
+      return entry.first;
+  }
+  return ns3::ndn::NeighbourhoodInfo::UNKNOWN;
+}
+
+// the last component of a request is its sequence number or parameters
+Name
+GetService(const Name& name)
+{
+  return name.size() > 1 ? name.getPrefix(-1) : name;
+}
+
+} // namespace
+
+ServiceStrategy::ServiceStrategy(Forwarder& forwarder, const Name& name)
+  : Strategy(forwarder)
+  , m_k(2)
+  , m_hedgeDelay(0)
+  , m_positiveTtl(ns3::Seconds(10))
+  , m_negativeTtl(ns3::Seconds(1))
+{
+  size_t cacheCapacity = 256;
+  double noisyRate = 0.2;
+  uint32_t maxInFlight = 0;
+  ns3::Time retireTime = ns3::MilliSeconds(1000);
+  ParsedInstanceName parsed = parseInstanceName(name);
+  for (const name::Component& component : parsed.parameters) {
+    std::string parameter(reinterpret_cast<const char*>(component.value()), component.value_size());
+    size_t tilde = parameter.find('~');
+    std::string key = parameter.substr(0, tilde);
+    std::string value = tilde == std::string::npos ? "" : parameter.substr(tilde + 1);
+    if (key == "k" && !value.empty())
+      m_k = std::stoul(value);
+    else if (key == "hedge" && !value.empty())
+      m_hedgeDelay = time::milliseconds(std::stoul(value));
+    else if (key == "cache" && !value.empty())
+      cacheCapacity = std::stoul(value);
+    else if (key == "ttl" && !value.empty())
+      m_positiveTtl = ns3::MilliSeconds(std::stoul(value));
+    else if (key == "nttl" && !value.empty())
+      m_negativeTtl = ns3::MilliSeconds(std::stoul(value));
+    else if (key == "fp" && !value.empty())
+      noisyRate = std::stoul(value) / 100.0;
+    else if (key == "balance" && !value.empty())
+      maxInFlight = std::stoul(value);
+    else if (key == "retire" && !value.empty())
+      retireTime = ns3::MilliSeconds(std::stoul(value));
+    else
+      BOOST_THROW_EXCEPTION(std::invalid_argument("Unknown ServiceStrategy parameter " + parameter));
+  }
+  m_cache = ns3::ndn::ResolutionCache(cacheCapacity);
+  m_trust = std::make_shared<ns3::ndn::FilterTrust>(noisyRate);
+  if (maxInFlight > 0)
+    m_balancer = std::make_shared<ns3::ndn::ProviderBalancer>(maxInFlight, retireTime);
+  this->setInstanceName(makeInstanceName(name, getStrategyName()));
+}
+
+const Name&
+ServiceStrategy::getStrategyName()
+{
+  static Name strategyName("/localhost/nfd/strategy/service/%FD%01");
+  return strategyName;
+}
+
+ns3::TracedCallback<uint32_t, uint32_t>&
+ServiceStrategy::GetForwardedTrace()
+{
+  static ns3::TracedCallback<uint32_t, uint32_t> trace;
+  return trace;
+}
+
+ns3::TracedCallback<uint32_t, const ::ndn::Name&, uint32_t, ns3::Time>&
+ServiceStrategy::GetResolvedTrace()
+{
+  static ns3::TracedCallback<uint32_t, const ::ndn::Name&, uint32_t, ns3::Time> trace;
+  return trace;
+}
+
+ns3::TracedCallback<uint32_t, uint32_t>&
+ServiceStrategy::GetCacheLookupTrace()
+{
+  static ns3::TracedCallback<uint32_t, uint32_t> trace;
+  return trace;
+}
+
+ns3::TracedCallback<uint32_t, ns3::Time>&
+ServiceStrategy::GetCacheSavingTrace()
+{
+  static ns3::TracedCallback<uint32_t, ns3::Time> trace;
+  return trace;
+}
+
+ns3::TracedCallback<uint32_t, uint32_t, bool>&
+ServiceStrategy::GetProbeTrace()
+{
+  static ns3::TracedCallback<uint32_t, uint32_t, bool> trace;
+  return trace;
+}
+
+ns3::TracedCallback<uint32_t, uint32_t>&
+ServiceStrategy::GetRebuildTrace()
+{
+  static ns3::TracedCallback<uint32_t, uint32_t> trace;
+  return trace;
+}
+
+ns3::TracedCallback<uint32_t, uint32_t>&
+ServiceStrategy::GetRetireTrace()
+{
+  static ns3::TracedCallback<uint32_t, uint32_t> trace;
+  return trace;
+}
+
+void
+ServiceStrategy::afterReceiveInterest(const Face& inFace, const Interest& interest,
+                                      const shared_ptr<pit::Entry>& pitEntry)
+{
+  if (hasPendingOutRecords(*pitEntry))
+    return; // a retransmission, the first copy is still on its way
+
+  ns3::Ptr<ns3::Node> node = ns3::NodeList::GetNode(ns3::Simulator::GetContext());
+  if (inFace.getScope() == ndn::nfd::FACE_SCOPE_LOCAL)
+    pitEntry->insertStrategyInfo<ResolutionInfo>(ns3::Simulator::Now());
+
+  // a provider on this node; every node has the root route to its Clusterproducer
+  std::vector<FaceId> faces;
+  Decision decision = TO_PROVIDER;
+  const fib::Entry& fibEntry = this->lookupFib(*pitEntry);
+  if (fibEntry.getPrefix().size() > 0) {
+    for (const fib::NextHop& nextHop : fibEntry.getNextHops()) {
+      const Face& face = nextHop.getFace();
+      if (face.getScope() == ndn::nfd::FACE_SCOPE_LOCAL && face.getId() != inFace.getId())
+        faces.push_back(face.getId());
+    }
+  }
+
+  ns3::Ptr<ns3::ndn::Clusterconsumer> consumer = ns3::ndn::Clusterconsumer::GetClusterconsumer(node);
+  bool resolved = !faces.empty();
+  if (!resolved && m_cache.GetCapacity() > 0 && consumer != 0 && consumer->IsSupernode()) {
+    LookupInfo* lookup = pitEntry->insertStrategyInfo<LookupInfo>(ns3::Simulator::Now()).first;
+    const ns3::ndn::ResolutionCache::Entry* entry =
+      m_cache.Find(GetService(interest.getName()), ns3::Simulator::Now());
+
+    if (entry == 0) {
+      GetCacheLookupTrace()(node->GetId(), CACHE_MISS);
+    }
+    else if (entry->negative) {
+      GetCacheLookupTrace()(node->GetId(), CACHE_NEGATIVE_HIT);
+      decision = NO_ROUTE;
+      resolved = true;
+    }
+    else if (entry->face != inFace.getId() && this->getFace(entry->face) != nullptr) {
+      GetCacheLookupTrace()(node->GetId(), CACHE_HIT);
+      faces.push_back(entry->face);
+      lookup->cached = true;
+      lookup->cachedLatency = entry->latency;
+      decision = FROM_CACHE;
+      resolved = true;
+    }
+    else {
+      GetCacheLookupTrace()(node->GetId(), CACHE_MISS); // back where it came from, or gone
+    }
+  }
+  if (!resolved)
+    decision = Resolve(consumer, interest, inFace, faces);
+
+  NFD_LOG_DEBUG(interest.getName() << " from face " << inFace.getId() << ": decision "
+                << decision << ", " << faces.size() << " faces");
+  GetForwardedTrace()(node->GetId(), decision);
+
+  if (faces.empty()) {
+    lp::NackHeader nackHeader;
+    nackHeader.setReason(lp::NackReason::NO_ROUTE);
+    this->sendNack(pitEntry, inFace, nackHeader);
+    this->rejectPendingInterest(pitEntry);
+    return;
+  }
+
+  // the best k candidate domains, all but the first hedged
+  if ((decision == TO_NEIGHBOURS || decision == TO_DISTANT) && m_k > 0 && faces.size() > m_k)
+    faces.resize(m_k);
+
+  // balanced: the first one by power of two choices, the others only after a Nack or the delay
+  bool balanced = m_balancer != nullptr && faces.size() > 1
+                  && (decision == TO_NEIGHBOURS || decision == TO_PROVIDERS);
+  if (balanced) {
+    FaceId first = m_balancer->Pick(faces, ns3::Simulator::Now(), getGlobalRng());
+    std::iter_swap(faces.begin(), std::find(faces.begin(), faces.end(), first));
+  }
+  bool hedged = (decision == TO_NEIGHBOURS || decision == TO_DISTANT)
+                && m_hedgeDelay > time::milliseconds::zero();
+  if ((balanced || hedged) && faces.size() > 1) {
+    HedgeInfo* info = pitEntry->insertStrategyInfo<HedgeInfo>().first;
+    info->pending.assign(faces.begin() + 1, faces.end());
+
+    // without a hedge delay a balanced request falls back on the others after twice the
+    // picked provider's SRTT, so a silent provider does not stall it until the lifetime ends
+    time::nanoseconds delay = m_hedgeDelay;
+    if (delay == time::nanoseconds::zero() && balanced)
+      delay = time::nanoseconds(m_balancer->GetTimeout(faces.front()).GetNanoSeconds());
+    if (delay > time::nanoseconds::zero()) {
+      weak_ptr<pit::Entry> weakEntry = pitEntry;
+      info->event = scheduler::schedule(delay, [this, weakEntry] { SendHedges(weakEntry); });
+    }
+    faces.resize(1);
+  }
+  if (decision == TO_NEIGHBOURS)
+    Probe(pitEntry, consumer, faces);
+
+  for (FaceId faceId : faces) {
+    Face* face = this->getFace(faceId);
+    if (face != nullptr) {
+      this->sendInterest(pitEntry, *face, interest);
+      Track(pitEntry, faceId);
+    }
+  }
+}
+
+void
+ServiceStrategy::SendHedges(weak_ptr<pit::Entry> weakEntry)
+{
+  shared_ptr<pit::Entry> pitEntry = weakEntry.lock();
+  if (pitEntry == nullptr)
+    return;
+
+  HedgeInfo* info = pitEntry->getStrategyInfo<HedgeInfo>();
+  if (info == nullptr || info->pending.empty())
+    return;
+
+  std::vector<FaceId> pending;
+  pending.swap(info->pending);
+  info->event.cancel();
+
+  NFD_LOG_DEBUG(pitEntry->getName() << " hedged to " << pending.size() << " more faces");
+  GetForwardedTrace()(ns3::Simulator::GetContext(), HEDGE);
+  ns3::Ptr<ns3::Node> node = ns3::NodeList::GetNode(ns3::Simulator::GetContext());
+  ns3::Ptr<ns3::ndn::Clusterconsumer> consumer = ns3::ndn::Clusterconsumer::GetClusterconsumer(node);
+  if (consumer != 0)
+    Probe(pitEntry, consumer, pending);
+  for (FaceId faceId : pending) {
+    Face* face = this->getFace(faceId);
+    if (face != nullptr) {
+      this->sendInterest(pitEntry, *face, pitEntry->getInterest());
+      Track(pitEntry, faceId);
+    }
+  }
+}
+
+void
+ServiceStrategy::Track(const shared_ptr<pit::Entry>& pitEntry, FaceId face)
+{
+  if (m_balancer == nullptr)
+    return;
+
+  pitEntry->insertStrategyInfo<BalanceInfo>(m_balancer).first->inFlight.insert(face);
+  if (m_balancer->Sent(face, ns3::Simulator::Now())) {
+    NFD_LOG_DEBUG("Face " << face << " overloaded, retired");
+    GetRetireTrace()(ns3::Simulator::GetContext(), face);
+  }
+}
+
+void
+ServiceStrategy::Probe(const shared_ptr<pit::Entry>& pitEntry,
+                       ns3::Ptr<ns3::ndn::Clusterconsumer> consumer, const std::vector<FaceId>& faces)
+{
+  ProbeInfo* info = pitEntry->insertStrategyInfo<ProbeInfo>(m_trust).first;
+  for (FaceId face : faces) {
+    uint32_t supernodeId = FindSupernode(consumer, face);
+    if (supernodeId == ns3::ndn::NeighbourhoodInfo::UNKNOWN)
+      continue;
+
+    info->pending[face] = supernodeId;
+    RequestRebuild(consumer, supernodeId, face);
+  }
+}
+
+void
+ServiceStrategy::RequestRebuild(ns3::Ptr<ns3::ndn::Clusterconsumer> consumer, uint32_t supernodeId,
+                                FaceId face)
+{
+  if (!m_trust->ShouldRebuild(supernodeId, ns3::Simulator::Now()))
+    return;
+
+  NFD_LOG_DEBUG("Filter of " << supernodeId << " is noisy, asking for a rebuild");
+  GetRebuildTrace()(ns3::Simulator::GetContext(), supernodeId);
+  consumer->RequestFilterRebuild(supernodeId, face);
+}
+
+ServiceStrategy::Decision
+ServiceStrategy::Resolve(ns3::Ptr<ns3::ndn::Clusterconsumer> consumer, const Interest& interest,
+                         const Face& inFace, std::vector<FaceId>& faces) const
+{
+  if (consumer == 0) {
+    Flood(inFace, faces);
+    return faces.empty() ? NO_ROUTE : TO_ALL;
+  }
+
+  const Name& name = interest.getName();
+  auto add = [&faces, &inFace](uint32_t face) {
+    if (face != 0 && face != inFace.getId() && std::find(faces.begin(), faces.end(), face) == faces.end())
+      faces.push_back(face);
+  };
+
+  bool isSupernode = consumer->IsSupernode();
+  if (isSupernode) {
+    const bloom_filter* domainFilter = consumer->GetDomainFilter();
+    const bloom_filter* domainShard =
+      consumer->GetDomainShard(ns3::ndn::ShardedFilter::GetShard(name));
+    if ((domainShard != 0 && Matches(*domainShard, name))
+        || (domainFilter != 0 && Matches(*domainFilter, name))) {
+      // the members whose own service filter matches, else all of them
+      std::vector<uint32_t> members = consumer->GetMemberFaces();
+      for (const auto& entry : consumer->GetMemberServiceFilters()) {
+        if (std::find(members.begin(), members.end(), entry.second.face) != members.end()
+            && Matches(entry.second, name))
+          add(entry.second.face);
+      }
+      if (!faces.empty())
+        return TO_PROVIDERS;
+
+      for (uint32_t face : members)
+        add(face);
+      if (!faces.empty())
+        return TO_MEMBERS;
+    }
+  }
+
+  // Rank the matching supernodes: longer matched prefix, then fewer false positives, observed
+  // or predicted, then closer. A member's own supernode is left to the steps below.
+  const auto& supernodeFilters = consumer->GetSupernodeFilters();
+  uint32_t supernodeId = consumer->GetSupernodeId();
+  // (unmatched components, false positive rate, hops, face)
+  std::vector<std::tuple<size_t, double, uint32_t, uint32_t>> candidates;
+  for (const auto& entry : supernodeFilters) {
+    double fpp = 1.0;
+    size_t length = entry.first != supernodeId ? MatchLength(entry.second, name, fpp) : 0;
+    if (length > 0)
+      candidates.emplace_back(name.size() - length, m_trust->GetRate(entry.first, fpp),
+                              consumer->GetSupernodeDistance(entry.first), entry.second.face);
+  }
+  std::sort(candidates.begin(), candidates.end());
+  for (const auto& candidate : candidates)
+    add(std::get<3>(candidate));
+  if (!faces.empty())
+    return TO_NEIGHBOURS;
+
+  // the domains further away, by their folded filters: longer match, then fewer overlay hops,
+  // then fewer predicted false positives
+  auto addDistant = [&] {
+    // (unmatched components, overlay hops, false positive rate, face)
+    std::vector<std::tuple<size_t, uint32_t, double, uint32_t>> distant;
+    for (const auto& entry : consumer->GetDistantFilters()) {
+      size_t length = entry.first != supernodeId ? MatchLength(entry.second.filter, name) : 0;
+      if (length > 0)
+        distant.emplace_back(name.size() - length, entry.second.hops,
+                             entry.second.filter.effective_fpp(), entry.second.face);
+    }
+    std::sort(distant.begin(), distant.end());
+    for (const auto& candidate : distant)
+      add(std::get<3>(candidate));
+    return !faces.empty();
+  };
+
+  uint32_t supernodeFace = consumer->GetSupernodeFace();
+  if (isSupernode || supernodeFace == 0) {
+    if (addDistant())
+      return TO_DISTANT;
+    Flood(inFace, faces);
+    return faces.empty() ? NO_ROUTE : TO_ALL;
+  }
+
+  auto own = supernodeFilters.find(supernodeId);
+  if (supernodeFace != inFace.getId()) {
+    // a known miss in the own domain is not worth the detour
+    if (own != supernodeFilters.end() && !Matches(own->second, name) && addDistant())
+      return TO_DISTANT;
+    faces.push_back(supernodeFace);
+    return TO_SUPERNODE;
+  }
+
+  // from the own supernode: a lookup in the domain this member cannot serve, or a flood that
+  // goes on to the supernodes of the other domains
+  if (own != supernodeFilters.end() && Matches(own->second, name))
+    return NO_ROUTE;
+  if (addDistant())
+    return TO_DISTANT;
+  for (const auto& entry : supernodeFilters)
+    add(entry.second.face);
+  return faces.empty() ? NO_ROUTE : TO_ALL;
+}
+
+void
+ServiceStrategy::Flood(const Face& inFace, std::vector<FaceId>& faces) const
+{
+  for (const Face& face : this->getFaceTable()) {
+    if (face.getScope() == ndn::nfd::FACE_SCOPE_NON_LOCAL && face.getId() != inFace.getId())
+      faces.push_back(face.getId());
+  }
+}
+
+void
+ServiceStrategy::beforeSatisfyInterest(const shared_ptr<pit::Entry>& pitEntry, const Face& inFace,
+                                       const Data& data)
+{
+  // first answer wins: the candidates not asked yet are not asked any more
+  HedgeInfo* hedges = pitEntry->getStrategyInfo<HedgeInfo>();
+  if (hedges != nullptr && !hedges->pending.empty()) {
+    NFD_LOG_DEBUG(pitEntry->getName() << " answered, " << hedges->pending.size()
+                  << " hedges cancelled");
+    hedges->pending.clear();
+    hedges->event.cancel();
+  }
+
+  // the RTT of the provider that answered, the others are no longer waited for
+  BalanceInfo* balance = pitEntry->getStrategyInfo<BalanceInfo>();
+  if (balance != nullptr) {
+    auto outRecord = pitEntry->getOutRecord(inFace);
+    for (FaceId face : balance->inFlight) {
+      if (face == inFace.getId() && outRecord != pitEntry->out_end()) {
+        time::nanoseconds rtt = time::steady_clock::now() - outRecord->getLastRenewed();
+        m_balancer->Answered(face, ns3::NanoSeconds(rtt.count()));
+      }
+      else {
+        m_balancer->Cancelled(face);
+      }
+    }
+    balance->inFlight.clear();
+  }
+
+  // a hit for the filter that brought the Data, the others have not had their chance
+  ProbeInfo* probes = pitEntry->getStrategyInfo<ProbeInfo>();
+  if (probes != nullptr) {
+    auto probe = probes->pending.find(inFace.getId());
+    if (probe != probes->pending.end()) {
+      m_trust->Record(probe->second, false);
+      GetProbeTrace()(ns3::Simulator::GetContext(), probe->second, false);
+    }
+    probes->pending.clear();
+  }
+
+  LookupInfo* lookup = pitEntry->getStrategyInfo<LookupInfo>();
+  if (lookup != nullptr) {
+    ns3::Time latency = ns3::Simulator::Now() - lookup->start;
+    if (lookup->cached)
+      GetCacheSavingTrace()(ns3::Simulator::GetContext(), lookup->cachedLatency - latency);
+    else
+      m_cache.InsertPositive(GetService(pitEntry->getName()), inFace.getId(), latency,
+                             ns3::Simulator::Now() + m_positiveTtl);
+  }
+
+  ResolutionInfo* info = pitEntry->getStrategyInfo<ResolutionInfo>();
+  if (info == nullptr)
+    return; // not requested on this node
+
+  uint32_t hops = 0;
+  auto hopCountTag = data.getTag<lp::HopCountTag>();
+  if (hopCountTag != nullptr)
+    hops = *hopCountTag;
+
+  GetResolvedTrace()(ns3::Simulator::GetContext(), pitEntry->getName(), hops,
+                     ns3::Simulator::Now() - info->start);
+}
+
+void
+ServiceStrategy::afterReceiveNack(const Face& inFace, const lp::Nack& nack,
+                                  const shared_ptr<pit::Entry>& pitEntry)
+{
+  // a failure of the provider, an overloaded one is retired
+  BalanceInfo* balance = pitEntry->getStrategyInfo<BalanceInfo>();
+  if (balance != nullptr && balance->inFlight.erase(inFace.getId()) > 0
+      && m_balancer->Failed(inFace.getId(), nack.getReason() == lp::NackReason::CONGESTION,
+                            ns3::Simulator::Now())) {
+    NFD_LOG_DEBUG("Face " << inFace.getId() << " retired after " << nack.getReason());
+    GetRetireTrace()(ns3::Simulator::GetContext(), inFace.getId());
+  }
+
+  // a false positive of the filter the request was sent on
+  ProbeInfo* probes = pitEntry->getStrategyInfo<ProbeInfo>();
+  if (probes != nullptr) {
+    auto probe = probes->pending.find(inFace.getId());
+    if (probe != probes->pending.end()) {
+      uint32_t supernodeId = probe->second;
+      probes->pending.erase(probe);
+      if (nack.getReason() == lp::NackReason::NO_ROUTE) {
+        m_trust->Record(supernodeId, true);
+        GetProbeTrace()(ns3::Simulator::GetContext(), supernodeId, true);
+
+        ns3::Ptr<ns3::Node> node = ns3::NodeList::GetNode(ns3::Simulator::GetContext());
+        ns3::Ptr<ns3::ndn::Clusterconsumer> consumer =
+          ns3::ndn::Clusterconsumer::GetClusterconsumer(node);
+        if (consumer != 0)
+          RequestRebuild(consumer, supernodeId, inFace.getId());
+      }
+    }
+  }
+
+  // a candidate without the service: ask the hedges right away
+  HedgeInfo* hedges = pitEntry->getStrategyInfo<HedgeInfo>();
+  if (hedges != nullptr && !hedges->pending.empty()) {
+    SendHedges(pitEntry);
+    return;
+  }
+
+  // Nack downstream once every upstream has
+  for (const pit::OutRecord& outRecord : pitEntry->getOutRecords()) {
+    if (outRecord.getIncomingNack() == nullptr)
+      return;
+  }
+
+  NFD_LOG_DEBUG(pitEntry->getName() << " not resolved");
+
+  // a stale cached face is dropped, a miss remembered
+  LookupInfo* lookup = pitEntry->getStrategyInfo<LookupInfo>();
+  if (lookup != nullptr && lookup->cached)
+    m_cache.Erase(GetService(pitEntry->getName()));
+  else if (lookup != nullptr)
+    m_cache.InsertNegative(GetService(pitEntry->getName()), ns3::Simulator::Now() + m_negativeTtl);
+  this->sendNacks(pitEntry, nack.getHeader());
+}
+
+} // namespace fw
+} // namespace nfd
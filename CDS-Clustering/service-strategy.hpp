@@ -0,0 +1,244 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef SERVICESTRATEGY
+#define SERVICESTRATEGY
+
+#include "face/face.hpp"
+#include "fw/strategy.hpp"
+
+#include "filter-trust.hpp"
+#include "provider-balancer.hpp"
+#include "resolution-cache.hpp"
+
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ns3/traced-callback.h"
+
+namespace ns3 {
+namespace ndn {
+class Clusterconsumer;
+} // namespace ndn
+} // namespace ns3
+
+namespace nfd {
+namespace fw {
+
+/**
+ * @brief Forwards service requests along the domain filters of the clustering
+ *
+ * Installed with StrategyChoiceHelper for the service namespace, e.g.
+ *
+ *     StrategyChoiceHelper::InstallAll("/service", ServiceStrategy::getStrategyName());
+ *
+ * A request is matched against a filter by its name prefixes, longest first. On every node
+ * a provider registered locally (a FIB entry below the root) is used first. Then
+ *
+ *  - a supernode sends the request to its members if its domainFilter matches, else to the
+ *    adjacent supernodes whose IIM filters match, and floods it as a last resort;
+ *  - a member sends it to the adjacent supernodes whose IIM filters match, else hands it to
+ *    its own supernode. A request coming down from its supernode is Nacked if that
+ *    supernode's filter matches (a false positive of the domain), otherwise it is part of a
+ *    flood and goes on to the adjacent supernodes of other domains.
+ *
+ * Where no adjacent supernode matches, the domains further away are tried before a flood, by
+ * the folded filters the supernodes pass over the overlay (Clusterconsumer::FilterReach):
+ * at a supernode, at a member whose own supernode's filter does not match, and at a member
+ * passing on a request from its supernode. Nodes on the way hold the same filters, each
+ * with the face towards its origin.
+ *
+ * Nodes without a Clusterconsumer flood.
+ *
+ * Matching adjacent supernodes are ranked by the length of the matched prefix, the false
+ * positive rate of their filter and their distance, and only the best k are asked. The
+ * first goes out at once, the others HedgeDelay later unless the Data or a Nack came back
+ * first; a Data cancels the hedges still pending. Both are strategy parameters, e.g.
+ *
+ *     /localhost/nfd/strategy/service/%FD%01/k~3/hedge~20
+ *
+ * for k = 3 and a hedge delay of 20 ms. The defaults are k = 2 and no delay, i.e. the two
+ * best candidates at once; k = 0 asks every match.
+ *
+ * Supernodes cache their resolutions (ResolutionCache) by service name, the request name
+ * without its last component: the face a Data came back on for `ttl~<ms>` (default 10 s),
+ * and names all upstreams Nacked for `nttl~<ms>` (default 1 s). A cached face is asked
+ * alone, a cached Nack is returned at once. `cache~<entries>` bounds the cache (default
+ * 256, 0 to turn it off).
+ *
+ * Every request sent to a supernode because its filter matched tells how far the filter can
+ * be trusted: a Nack or a timeout was a false positive. Once a filter has enough of these
+ * samples, the observed rate replaces the predicted one in the ranking (FilterTrust), and a
+ * filter with more than `fp~<percent>` false positives (default 20, 0 never) is asked to be
+ * rebuilt from the current members of its domain.
+ *
+ * A supernode sends a request matching its domain filter to the members whose own service
+ * filter matches, if it knows any, else to all members. With `balance~<n>` (default 0, off)
+ * a request with several candidates, providers in the domain or adjacent domains, goes to one
+ * of them picked by power of two choices on their load and RTT (ProviderBalancer); the others
+ * are hedges. So balancing turns the k candidates asked at once into a sequence: the hedges go
+ * out after a Nack, after the hedge delay, or, with no hedge delay, after twice the picked
+ * provider's SRTT. A provider without an RTT yet is only followed up on a Nack or when the
+ * Interest expires. A provider with more than n requests in flight, a congestion Nack or three
+ * failures in a row is passed over for `retire~<ms>` (default 1000).
+ */
+class ServiceStrategy : public Strategy {
+public:
+  /// How a node forwarded a request
+  enum Decision {
+    TO_PROVIDER = 0,   ///< to a provider on this node
+    TO_MEMBERS = 1,    ///< a supernode to its members
+    TO_NEIGHBOURS = 2, ///< to adjacent supernodes with a matching filter
+    TO_SUPERNODE = 3,  ///< a member to its own supernode
+    TO_ALL = 4,        ///< flooded
+    NO_ROUTE = 5,      ///< Nacked
+    HEDGE = 6,         ///< further candidates sent after HedgeDelay
+    FROM_CACHE = 7,    ///< a supernode to the face in its resolution cache
+    TO_PROVIDERS = 8,  ///< a supernode to the members whose service filter matches
+    TO_DISTANT = 9     ///< towards domains beyond the adjacent ones whose folded filter matches
+  };
+
+  /// Resolution cache lookups of a supernode
+  enum CacheOutcome {
+    CACHE_MISS = 0,
+    CACHE_HIT = 1,
+    CACHE_NEGATIVE_HIT = 2
+  };
+
+  typedef void (*ForwardedCallback)(uint32_t nodeId, uint32_t decision);
+  typedef void (*ResolvedCallback)(uint32_t nodeId, const ::ndn::Name& name, uint32_t hops,
+                                   ns3::Time latency);
+  typedef void (*CacheLookupCallback)(uint32_t nodeId, uint32_t outcome);
+  typedef void (*CacheSavingCallback)(uint32_t nodeId, ns3::Time saving);
+  typedef void (*ProbeCallback)(uint32_t nodeId, uint32_t supernodeId, bool falsePositive);
+  typedef void (*RebuildCallback)(uint32_t nodeId, uint32_t supernodeId);
+  typedef void (*RetireCallback)(uint32_t nodeId, uint32_t face);
+
+  explicit
+  ServiceStrategy(Forwarder& forwarder, const Name& name = getStrategyName());
+
+  static const Name&
+  getStrategyName();
+
+  /**
+   * @brief Fired on every forwarding decision (node id, Decision)
+   *
+   * The strategy is not an ns-3 Object, so its trace sources are shared by all instances.
+   */
+  static ns3::TracedCallback<uint32_t, uint32_t>&
+  GetForwardedTrace();
+
+  /**
+   * @brief Fired on the requesting node when the Data of a request arrives (node id, name,
+   *        hops of the Data, time since the request)
+   */
+  static ns3::TracedCallback<uint32_t, const ::ndn::Name&, uint32_t, ns3::Time>&
+  GetResolvedTrace();
+
+  /**
+   * @brief Fired on every resolution cache lookup of a supernode (node id, CacheOutcome)
+   */
+  static ns3::TracedCallback<uint32_t, uint32_t>&
+  GetCacheLookupTrace();
+
+  /**
+   * @brief Fired when a request sent to a cached face is answered (node id, latency of the
+   *        resolution that filled the entry minus the latency of this one)
+   */
+  static ns3::TracedCallback<uint32_t, ns3::Time>&
+  GetCacheSavingTrace();
+
+  /**
+   * @brief Fired when a request sent on a supernode filter is answered, Nacked or timed out
+   *        (node id, supernode id, whether the filter matched falsely)
+   */
+  static ns3::TracedCallback<uint32_t, uint32_t, bool>&
+  GetProbeTrace();
+
+  /**
+   * @brief Fired when a supernode is asked to rebuild its noisy filter (node id, supernode id)
+   */
+  static ns3::TracedCallback<uint32_t, uint32_t>&
+  GetRebuildTrace();
+
+  /**
+   * @brief Fired when a provider face is retired as overloaded (node id, face id)
+   */
+  static ns3::TracedCallback<uint32_t, uint32_t>&
+  GetRetireTrace();
+
+  void
+  afterReceiveInterest(const Face& inFace, const Interest& interest,
+                       const shared_ptr<pit::Entry>& pitEntry) override;
+
+  void
+  beforeSatisfyInterest(const shared_ptr<pit::Entry>& pitEntry, const Face& inFace,
+                        const Data& data) override;
+
+  void
+  afterReceiveNack(const Face& inFace, const lp::Nack& nack,
+                   const shared_ptr<pit::Entry>& pitEntry) override;
+
+private:
+  /**
+   * @brief Send the hedges of a request that is still pending
+   */
+  void
+  SendHedges(weak_ptr<pit::Entry> pitEntry);
+
+  /**
+   * @brief Note the requests sent on supernode filters, for FilterTrust, and ask the noisy
+   *        supernodes among them for a rebuild
+   */
+  void
+  Probe(const shared_ptr<pit::Entry>& pitEntry, ns3::Ptr<ns3::ndn::Clusterconsumer> consumer,
+        const std::vector<FaceId>& faces);
+
+  /**
+   * @brief Count a request sent on face in flight, for ProviderBalancer
+   */
+  void
+  Track(const shared_ptr<pit::Entry>& pitEntry, FaceId face);
+
+  void
+  RequestRebuild(ns3::Ptr<ns3::ndn::Clusterconsumer> consumer, uint32_t supernodeId, FaceId face);
+
+  Decision
+  Resolve(ns3::Ptr<ns3::ndn::Clusterconsumer> consumer, const Interest& interest,
+          const Face& inFace, std::vector<FaceId>& faces) const;
+
+  void
+  Flood(const Face& inFace, std::vector<FaceId>& faces) const;
+
+private:
+  size_t m_k;                      // candidate supernodes asked, 0 for all
+  time::milliseconds m_hedgeDelay; // before asking all but the best
+
+  ns3::ndn::ResolutionCache m_cache;
+  ns3::Time m_positiveTtl;
+  ns3::Time m_negativeTtl;
+
+  // shared with the requests still pending, which report their timeouts
+  std::shared_ptr<ns3::ndn::FilterTrust> m_trust;
+  std::shared_ptr<ns3::ndn::ProviderBalancer> m_balancer; // null unless balance~<n>
+};
+
+} // namespace fw
+} // namespace nfd
+
+#endif
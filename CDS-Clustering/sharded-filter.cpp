@@ -0,0 +1,176 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "sharded-filter.hpp"
+
+#include <bitset>
+#include <cmath>
+#include <functional>
+
+namespace ns3 {
+namespace ndn {
+
+const uint32_t ShardedFilter::SHARDS;
+const uint64_t ShardedFilter::MIN_CAPACITY;
+
+namespace {
+
+bool
+SameShape(const bloom_filter& a, const bloom_filter& b)
+{
+  return a.size() == b.size() && a.salt_count() == b.salt_count();
+}
+
+} // namespace
+
+uint32_t
+ShardedFilter::GetShard(const Name& name)
+{
+  if (name.empty())
+    return 0;
+  return std::hash<std::string>()(name.at(0).toUri()) % SHARDS;
+}
+
+bloom_filter
+ShardedFilter::MakeShape(uint64_t capacity)
+{
+  return bloom_filter(capacity, FPP, UNIVERSAL_SEED);
+}
+
+double
+ShardedFilter::GetFpp(const bloom_filter& filter)
+{
+  if (filter.size() == 0)
+    return 1.0;
+
+  uint64_t set = 0;
+  const unsigned char* table = filter.table();
+  for (size_t i = 0; i < filter.size() / 8; i++)
+    set += std::bitset<8>(table[i]).count();
+  return std::pow(static_cast<double>(set) / filter.size(), filter.salt_count());
+}
+
+ShardedFilter::ShardedFilter(double fpp)
+  : m_fpp(fpp)
+{
+}
+
+void
+ShardedFilter::Merge(uint32_t shard, const bloom_filter& filter)
+{
+  Shard& entry = GetOrCreate(shard);
+  if (SameShape(entry.filter, filter)) {
+    bloom_filter previous = entry.filter;
+    entry.filter |= filter;
+    entry.changed |= !(entry.filter == previous);
+  }
+  if (entry.filling && SameShape(entry.fresh, filter)) {
+    entry.fresh |= filter;
+    entry.freshMerges++;
+  }
+}
+
+const bloom_filter*
+ShardedFilter::Get(uint32_t shard) const
+{
+  auto entry = m_shards.find(shard);
+  return entry != m_shards.end() ? &entry->second.filter : 0;
+}
+
+uint64_t
+ShardedFilter::GetCapacity(uint32_t shard) const
+{
+  auto entry = m_shards.find(shard);
+  if (entry == m_shards.end())
+    return MIN_CAPACITY;
+  return entry->second.capacity;
+}
+
+void
+ShardedFilter::Update(Time now, Time period)
+{
+  for (auto& entry : m_shards) {
+    Shard& shard = entry.second;
+    if (shard.filling) {
+      // a full period: every member has sent its filter at the new capacity; without any,
+      // the old table keeps serving until one arrives
+      if (now - shard.fillStart < period || shard.freshMerges == 0)
+        continue;
+
+      shard.filling = false;
+      shard.filter = shard.fresh;
+      shard.changed = true;
+    }
+    else if (GetFpp(shard.filter) > 2 * m_fpp) {
+      StartFill(shard, shard.capacity * 2, now);
+    }
+  }
+}
+
+void
+ShardedFilter::Restart(Time now)
+{
+  for (auto& entry : m_shards) {
+    if (!entry.second.filling)
+      StartFill(entry.second, entry.second.capacity, now);
+  }
+}
+
+std::vector<uint32_t>
+ShardedFilter::TakeChanged(bool all)
+{
+  std::vector<uint32_t> changed;
+  for (auto& entry : m_shards) {
+    if (all || entry.second.changed)
+      changed.push_back(entry.first);
+    entry.second.changed = false;
+  }
+  return changed;
+}
+
+ShardedFilter::Shard&
+ShardedFilter::GetOrCreate(uint32_t shard)
+{
+  auto entry = m_shards.find(shard);
+  if (entry != m_shards.end())
+    return entry->second;
+
+  Shard& created = m_shards[shard];
+  created.filter = MakeShape(MIN_CAPACITY);
+  created.capacity = MIN_CAPACITY;
+  created.filling = false;
+  created.fresh = created.filter;
+  created.freshMerges = 0;
+  created.changed = true;
+  return created;
+}
+
+void
+ShardedFilter::StartFill(Shard& shard, uint64_t capacity, Time now)
+{
+  shard.capacity = capacity;
+  shard.filling = true;
+  shard.fillStart = now;
+  shard.fresh = MakeShape(capacity);
+  shard.freshMerges = 0;
+  shard.changed = true; // the new capacity is announced
+}
+
+} // namespace ndn
+} // namespace ns3
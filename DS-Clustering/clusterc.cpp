@@ -1,305 +1,1965 @@
-/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
-/**
- * Copyright (c) 2011-2015  Regents of the University of California.
- *
- * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
- * contributors.
- *
- * ndnSIM is free software: you can redistribute it and/or modify it under the terms
- * of the GNU General Public License as published by the Free Software Foundation,
- * either version 3 of the License, or (at your option) any later version.
- *
- * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
- * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
- * PURPOSE.  See the GNU General Public License for more details.
- *
- * You should have received a copy of the GNU General Public License along with
- * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
- **/
-
-#include "clusterc.hpp"
-#include "ns3/ptr.h"
-#include "ns3/log.h"
-#include "ns3/simulator.h"
-#include "ns3/packet.h"
-#include "ns3/callback.h"
-#include "ns3/string.h"
-#include "ns3/boolean.h"
-#include "ns3/uinteger.h"
-#include "ns3/integer.h"
-#include "ns3/double.h"
-
-#include "supernode-ds.hpp"
-
-#include <ndn-cxx/lp/tags.hpp>
-#include <stdint.h>
-
-NS_LOG_COMPONENT_DEFINE("Clusterconsumer");
-
-namespace ns3 {
-namespace ndn {
-
-NS_OBJECT_ENSURE_REGISTERED(Clusterconsumer);
-
-TypeId
-Clusterconsumer::GetTypeId(void)
-{
-  static TypeId tid =
-    TypeId("ns3::ndn::Clusterconsumer")
-      .SetGroupName("Ndn")
-      .SetParent<Consumer>()
-      .AddConstructor<Clusterconsumer>()
-
-      .AddAttribute("Frequency", "Frequency of interest packets", StringValue("0.001"),
-                    MakeDoubleAccessor(&Clusterconsumer::m_frequency), MakeDoubleChecker<double>())
-
-      .AddAttribute("Randomize",
-                    "Type of send time randomization: none (default), uniform, exponential",
-                    StringValue("none"),
-                    MakeStringAccessor(&Clusterconsumer::SetRandomize, &Clusterconsumer::GetRandomize),
-                    MakeStringChecker())
-
-      .AddAttribute("MaxSeq", "Maximum sequence number to request",
-                    IntegerValue(std::numeric_limits<uint32_t>::max()),
-                    MakeIntegerAccessor(&Clusterconsumer::m_seqMax), MakeIntegerChecker<uint32_t>())
-
-    ;
-
-  return tid;
-}
-
-Clusterconsumer::Clusterconsumer()
-  : m_frequency(1.0)
-  , m_firstTime(true)
-  , m_answers(0)
-{
-  m_seqMax = std::numeric_limits<uint32_t>::max();
-}
-
-Clusterconsumer::~Clusterconsumer()
-{
-}
-
-// Application Methods
-void
-Clusterconsumer::StartApplication() // Called at time specified by Start
-{
-  NS_LOG_FUNCTION_NOARGS();
-
-  // do base stuff
-  App::StartApplication();
-
-  // Adds own values into neighbouring table
-  best_nId = this->GetNode()->GetId();
-  best_face = 0;
-  best_nN = this->GetNode()->GetNDevices();
-
-  ScheduleNextPacket();
-}
-
-
-void
-Clusterconsumer::ScheduleNextPacket()
-{
-  // double mean = 8.0 * m_payloadSize / m_desiredRate.GetBitRate ();
-  // std::cout << "next: " << Simulator::Now().ToDouble(Time::S) + mean << "s\n";
-
-  if (m_firstTime) {
-    m_sendEvent = Simulator::Schedule(Seconds(0.0), &Clusterconsumer::SendPacket, this);
-    m_firstTime = false;
-  }
-  else if (!m_sendEvent.IsRunning())
-    m_sendEvent = Simulator::Schedule((m_random == 0) ? Seconds(1.0 / m_frequency)
-                                                      : Seconds(m_random->GetValue()),
-                                      &Clusterconsumer::SendPacket, this);
-}
-
-void
-Clusterconsumer::SendPacket()
-{
-  if (!m_active)
-    return;
-
-  //NS_LOG_FUNCTION_NOARGS();
-
-  uint32_t seq = std::numeric_limits<uint32_t>::max(); // invalid
-
-  while (m_retxSeqs.size()) {
-    seq = *m_retxSeqs.begin();
-    m_retxSeqs.erase(m_retxSeqs.begin());
-    break;
-  }
-
-  if (seq == std::numeric_limits<uint32_t>::max()) {
-    if (m_seqMax != std::numeric_limits<uint32_t>::max()) {
-      if (m_seq >= m_seqMax) {
-        return; // we are totally done
-      }
-    }
-
-    seq = m_seq++;
-  }
-
-  shared_ptr<Name> nameWithSequence = make_shared<Name>(m_interestName);
-  nameWithSequence->append("CII");
-  nameWithSequence->appendNumber(this->GetNode()->GetId());
-
-  shared_ptr<Interest> interest = make_shared<Interest>();
-  interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
-  interest->setName(*nameWithSequence);
-  time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
-  interest->setInterestLifetime(interestLifeTime);
-  interest->setCII();
-
-  NS_LOG_INFO("Sending " << interest->getName());
-  
-  WillSendOutInterest(seq);
-
-  m_transmittedInterests(interest, this, m_face);
-  m_appLink->onReceiveInterest(*interest);
-
-  ScheduleNextPacket();
-}
-
-
-void
-Clusterconsumer::SetRandomize(const std::string& value)
-{
-  if (value == "uniform") {
-    m_random = CreateObject<UniformRandomVariable>();
-    m_random->SetAttribute("Min", DoubleValue(0.0));
-    m_random->SetAttribute("Max", DoubleValue(2 * 1.0 / m_frequency));
-  }
-  else if (value == "exponential") {
-    m_random = CreateObject<ExponentialRandomVariable>();
-    m_random->SetAttribute("Mean", DoubleValue(1.0 / m_frequency));
-    m_random->SetAttribute("Bound", DoubleValue(50 * 1.0 / m_frequency));
-  }
-  else
-    m_random = 0;
-
-  m_randomType = value;
-}
-
-std::string
-Clusterconsumer::GetRandomize() const
-{
-  return m_randomType;
-}
-
-
-void
-Clusterconsumer::OnData(shared_ptr<const Data> data)
-{
-  if (!m_active)
-    return;
-
-  App::OnData(data); // tracing inside
-
-  NS_LOG_INFO(data->getName() << " from " << data->getNodeId() << " received");
-
-  uint32_t seq = 0;
-
-  int hopCount = 0;
-  auto hopCountTag = data->getTag<lp::HopCountTag>();
-  if (hopCountTag != nullptr) { // e.g., packet came from local node's cache
-    hopCount = *hopCountTag;
-  }
-
-  SeqTimeoutsContainer::iterator entry = m_seqLastDelay.find(seq);
-  if (entry != m_seqLastDelay.end()) {
-    m_lastRetransmittedInterestDataDelay(this, seq, Simulator::Now() - entry->time, hopCount);
-  }
-
-  entry = m_seqFullDelay.find(seq);
-  if (entry != m_seqFullDelay.end()) {
-    m_firstInterestDataDelay(this, seq, Simulator::Now() - entry->time, m_seqRetxCounts[seq], hopCount);
-  }
-
-  m_seqRetxCounts.erase(seq);
-  m_seqFullDelay.erase(seq);
-  m_seqLastDelay.erase(seq);
-
-  m_seqTimeouts.erase(seq);
-  m_retxSeqs.erase(seq);
-
-  m_rtt->AckSeq(SequenceNumber32(seq));
-
-  // When a data with neighbours is received, the data is stored in a list
-  if (data->getNeighbours() > 0) {
-    m_answers++;
-    NEntry nEntry = {data->getNodeId(), data->getFaceId(), data->getNeighbours()};
-    m_neighbours.push_back(nEntry);
-    if (data->getNeighbours() > best_nN) {
-      best_nId = data->getNodeId();
-      best_face = data->getFaceId();
-      best_nN = data->getNeighbours();
-    }
-    
-
-    // When there has been an answer from all neighbouring nodes, the neighbour with the highest degree is calculated
-    if (m_answers >= this->GetNode()->GetNDevices())
-    {
-      if (best_face == 0)
-      {
-        best_face = data->getSCIFace();
-        NEntry nEntry = {best_nId, best_face, best_nN};
-        m_neighbours.insert(m_neighbours.begin(), nEntry);
-      }
-      BestNeighbour();
-    }
-  } 
-  if (data->isSCI()) {
-    NS_LOG_INFO("Setting node " << data->getNodeId() << " as it's Supernode through face " << data->getFaceId());
-    this->GetNode()->SetSupernodeFace(data->getFaceId());
-  }
-}
-
-void Clusterconsumer::BestNeighbour()
-{
-  for (std::vector<NEntry>::iterator it = m_neighbours.begin() ; it != m_neighbours.end(); ++it)
-    NS_LOG_DEBUG("Node= " << (*it).getNodeId() << ", Face= " << (*it).getFaceId() << ", Neighbours= " << (*it).getNeighbours());
-
-  if (best_nId == this->GetNode()->GetId()) {
-    NS_LOG_INFO("This node is best with " << best_nN << " neighbours");
-
-    if (!this->GetNode()->IsSupernode())
-    {    
-      this->GetNode()->AddApplication(new Supernode);
-      this->GetNode()->SetAsSupernode();
-      this->GetNode()->SetSupernodeFace(best_face);
-    }
-  } else {
-    NS_LOG_INFO("Best neighbour is Node " << best_nId << " with " << best_nN << " neighbours"); 
-    SendSupernode();   
-  }
-}
-
-void Clusterconsumer::SendSupernode()
-{
-  uint32_t seq = m_seq++;
-
-  shared_ptr<Name> nameWithSequence = make_shared<Name>("ndn:/localhop/Cluster/SCI");
-  nameWithSequence->appendNumber(this->GetNode()->GetId());
-
-  shared_ptr<Interest> interest = make_shared<Interest>();
-  interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
-  interest->setName(*nameWithSequence);
-  time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
-  interest->setInterestLifetime(interestLifeTime);
-  interest->setSCI();
-
-  shared_ptr<ndn::lp::NextHopFaceIdTag> tag = make_shared<ndn::lp::NextHopFaceIdTag>(best_face);
-  interest->setTag(tag);
-
-  NS_LOG_INFO("Sending " << interest->getName() << " to Node " << best_nId);
-  
-  WillSendOutInterest(seq);
-
-  m_transmittedInterests(interest, this, m_face);
-  m_appLink->onReceiveInterest(*interest);
-  return;
-}
-
-} // namespace ndn
-} // namespace ns3
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "clusterc.hpp"
+#include "ns3/ptr.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "ns3/callback.h"
+#include "ns3/string.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/integer.h"
+#include "ns3/double.h"
+#include "ns3/net-device.h"
+#include "ns3/data-rate.h"
+
+#include "supernode-ds.hpp"
+#include "bloom-filter-util.hpp"
+
+#include "resource-class.hpp"
+#include "sharded-filter.hpp"
+
+#include <ndn-cxx/lp/tags.hpp>
+#include <algorithm>
+#include <cmath>
+#include <stdint.h>
+
+NS_LOG_COMPONENT_DEFINE("Clusterconsumer");
+
+namespace ns3 {
+namespace ndn {
+
+NS_OBJECT_ENSURE_REGISTERED(Clusterconsumer);
+
+TypeId
+Clusterconsumer::GetTypeId(void)
+{
+  static TypeId tid =
+    TypeId("ns3::ndn::Clusterconsumer")
+      .SetGroupName("Ndn")
+      .SetParent<Consumer>()
+      .AddConstructor<Clusterconsumer>()
+
+      .AddAttribute("Frequency", "Frequency of interest packets", StringValue("0.001"),
+                    MakeDoubleAccessor(&Clusterconsumer::m_frequency), MakeDoubleChecker<double>())
+
+      .AddAttribute("Randomize",
+                    "Type of send time randomization: none (default), uniform, exponential",
+                    StringValue("none"),
+                    MakeStringAccessor(&Clusterconsumer::SetRandomize, &Clusterconsumer::GetRandomize),
+                    MakeStringChecker())
+
+      .AddAttribute("Election",
+                    "Supernode election: coverage (greedy on the 2-hop neighbourhood), weighted "
+                    "(coverage ranked by span times score) or degree (best score among the "
+                    "neighbours, which is the degree with the default weights, the default)",
+                    StringValue("degree"),
+                    MakeStringAccessor(&Clusterconsumer::m_election), MakeStringChecker())
+
+      .AddAttribute("Cpu", "Relative CPU capacity of the node, for the score", DoubleValue(1.0),
+                    MakeDoubleAccessor(&Clusterconsumer::m_cpu), MakeDoubleChecker<double>(0.0))
+
+      .AddAttribute("Ram", "Memory of the node in GB, for the score", DoubleValue(1.0),
+                    MakeDoubleAccessor(&Clusterconsumer::m_ram), MakeDoubleChecker<double>(0.0))
+
+      .AddAttribute("Load", "Current load of the node, 0 (idle) to 1 (saturated), for the score",
+                    DoubleValue(0.0), MakeDoubleAccessor(&Clusterconsumer::m_load),
+                    MakeDoubleChecker<double>(0.0, 1.0))
+
+      .AddAttribute("WeightDegree", "Score weight of a neighbour", DoubleValue(1.0),
+                    MakeDoubleAccessor(&Clusterconsumer::m_weightDegree), MakeDoubleChecker<double>())
+
+      .AddAttribute("WeightCpu", "Score weight of a unit of Cpu", DoubleValue(0.0),
+                    MakeDoubleAccessor(&Clusterconsumer::m_weightCpu), MakeDoubleChecker<double>())
+
+      .AddAttribute("WeightRam", "Score weight of a GB of Ram", DoubleValue(0.0),
+                    MakeDoubleAccessor(&Clusterconsumer::m_weightRam), MakeDoubleChecker<double>())
+
+      .AddAttribute("WeightLink", "Score weight of a Gbps of link capacity", DoubleValue(0.0),
+                    MakeDoubleAccessor(&Clusterconsumer::m_weightLink), MakeDoubleChecker<double>())
+
+      .AddAttribute("WeightLoad", "Score penalty of full Load", DoubleValue(0.0),
+                    MakeDoubleAccessor(&Clusterconsumer::m_weightLoad), MakeDoubleChecker<double>())
+
+      .AddAttribute("LoadThreshold",
+                    "Load above which a supernode hands its role to a neighbour, 0 never",
+                    DoubleValue(0.0), MakeDoubleAccessor(&Clusterconsumer::m_loadThreshold),
+                    MakeDoubleChecker<double>(0.0, 1.0))
+
+      .AddAttribute("MaxMembers", "Members per CII period at which a supernode is fully loaded, 0 "
+                    "to not count members",
+                    UintegerValue(0),
+                    MakeUintegerAccessor(&Clusterconsumer::m_maxMembers), MakeUintegerChecker<uint32_t>())
+
+      .AddAttribute("MaxMergeRate", "Filter merges per second at which a supernode is fully "
+                    "loaded, 0 to not count merges",
+                    DoubleValue(0.0), MakeDoubleAccessor(&Clusterconsumer::m_maxMergeRate),
+                    MakeDoubleChecker<double>(0.0))
+
+      .AddAttribute("RotationCooldown",
+                    "Time after a handover during which the node is not elected again",
+                    StringValue("30s"), MakeTimeAccessor(&Clusterconsumer::m_rotationCooldown),
+                    MakeTimeChecker())
+
+      .AddAttribute("MaxDomainSize",
+                    "Members a supernode admits, further SCIs are refused; 0 for no limit",
+                    UintegerValue(0),
+                    MakeUintegerAccessor(&Clusterconsumer::m_maxDomainSize), MakeUintegerChecker<uint32_t>())
+
+      .AddAttribute("MinDomainSize",
+                    "Members below which a supernode is preferred by joining nodes, 0 for no "
+                    "preference",
+                    UintegerValue(0),
+                    MakeUintegerAccessor(&Clusterconsumer::m_minDomainSize), MakeUintegerChecker<uint32_t>())
+
+      .AddAttribute("K", "Maximum number of hops between a member and its supernode",
+                    UintegerValue(1),
+                    MakeUintegerAccessor(&Clusterconsumer::m_k), MakeUintegerChecker<uint32_t>(1))
+
+      .AddAttribute("MaxLevel",
+                    "Levels of supernodes: 1 for plain DS/CDS domains, more to run the election "
+                    "again on the supernode overlay",
+                    UintegerValue(1),
+                    MakeUintegerAccessor(&Clusterconsumer::m_maxLevel), MakeUintegerChecker<uint32_t>(1))
+
+      .AddAttribute("FilterReach",
+                    "Overlay hops a domain filter travels, folded once for every hop beyond the "
+                    "first; 1 leaves it to the adjacent domains (needs MaxLevel > 1)",
+                    UintegerValue(1),
+                    MakeUintegerAccessor(&Clusterconsumer::m_filterReach), MakeUintegerChecker<uint32_t>(1))
+
+      .AddAttribute("DoubleDomination",
+                    "Elect so that every node has a primary and a secondary supernode, which "
+                    "keeps a warm copy of the primary's domain filter",
+                    BooleanValue(false),
+                    MakeBooleanAccessor(&Clusterconsumer::m_doubleDomination), MakeBooleanChecker())
+
+      .AddAttribute("RepairHops",
+                    "Hops around a link change or lost neighbour that re-pull their neighbourhood "
+                    "at once; 0 leaves repairs to the periodic CII rounds",
+                    UintegerValue(2),
+                    MakeUintegerAccessor(&Clusterconsumer::m_repairHops), MakeUintegerChecker<uint32_t>())
+
+      .AddAttribute("RepairDelay", "Time over which repair requests are coalesced into one CII",
+                    StringValue("10ms"), MakeTimeAccessor(&Clusterconsumer::m_repairDelay),
+                    MakeTimeChecker())
+
+      .AddAttribute("MaxFrequency",
+                    "CII frequency while the neighbour set changes every round, e.g. under "
+                    "mobility; the frequency follows the churn between Frequency and this, "
+                    "0 keeps it at Frequency",
+                    DoubleValue(0.0), MakeDoubleAccessor(&Clusterconsumer::m_maxFrequency),
+                    MakeDoubleChecker<double>(0.0))
+
+      .AddAttribute("ChurnWeight", "Weight of the last round in the churn moving average",
+                    DoubleValue(0.25), MakeDoubleAccessor(&Clusterconsumer::m_churnWeight),
+                    MakeDoubleChecker<double>(0.0, 1.0))
+
+      .AddAttribute("HandoverMargin",
+                    "How much more than better (neighbours, or hops closer with K > 1) another "
+                    "supernode has to be for a member to leave its current one; 0 switches to "
+                    "any strictly better one",
+                    UintegerValue(0),
+                    MakeUintegerAccessor(&Clusterconsumer::m_handoverMargin), MakeUintegerChecker<uint32_t>())
+
+      .AddAttribute("KeepSupernode",
+                    "Stay with the current supernode for as long as it is reachable, whatever "
+                    "HandoverMargin",
+                    BooleanValue(false),
+                    MakeBooleanAccessor(&Clusterconsumer::m_keepSupernode), MakeBooleanChecker())
+
+      .AddAttribute("MissedRounds",
+                    "CII rounds a neighbour may stay silent before it is considered gone",
+                    UintegerValue(3),
+                    MakeUintegerAccessor(&Clusterconsumer::m_missedRounds), MakeUintegerChecker<uint32_t>(1))
+
+      .AddAttribute("MaxSeq", "Maximum sequence number to request",
+                    IntegerValue(std::numeric_limits<uint32_t>::max()),
+                    MakeIntegerAccessor(&Clusterconsumer::m_seqMax), MakeIntegerChecker<uint32_t>())
+
+      .AddTraceSource("RoleChanged", "Node became a supernode",
+                      MakeTraceSourceAccessor(&Clusterconsumer::m_roleChanged),
+                      "ns3::ndn::Clusterconsumer::RoleChangedCallback")
+
+      .AddTraceSource("SupernodeChanged", "Node joined the domain of a supernode",
+                      MakeTraceSourceAccessor(&Clusterconsumer::m_supernodeChanged),
+                      "ns3::ndn::Clusterconsumer::SupernodeChangedCallback")
+
+      .AddTraceSource("Failover", "Node switched to its secondary supernode",
+                      MakeTraceSourceAccessor(&Clusterconsumer::m_failover),
+                      "ns3::ndn::Clusterconsumer::FailoverCallback")
+
+      .AddTraceSource("Repair", "Node started a repair round",
+                      MakeTraceSourceAccessor(&Clusterconsumer::m_repaired),
+                      "ns3::ndn::Clusterconsumer::RepairCallback")
+
+      .AddTraceSource("Handover", "Supernode handed its role to a neighbour",
+                      MakeTraceSourceAccessor(&Clusterconsumer::m_handedOver),
+                      "ns3::ndn::Clusterconsumer::HandoverCallback")
+
+      .AddTraceSource("LevelChanged", "Node became a supernode of a higher overlay level",
+                      MakeTraceSourceAccessor(&Clusterconsumer::m_levelChanged),
+                      "ns3::ndn::Clusterconsumer::LevelChangedCallback")
+
+      .AddTraceSource("DistantFilterSent", "Supernode sent a domain filter beyond its adjacent domains",
+                      MakeTraceSourceAccessor(&Clusterconsumer::m_distantFilterSent),
+                      "ns3::ndn::Clusterconsumer::DistantFilterSentCallback")
+
+    ;
+
+  return tid;
+}
+
+Clusterconsumer::Clusterconsumer()
+  : m_frequency(1.0)
+  , m_firstTime(true)
+  , m_round(0)
+  , m_roundElected(false)
+  , m_repairRound(false)
+  , m_localFace(0)
+  , m_missedRounds(3)
+  , m_repairHops(2)
+  , m_pendingRepair(0)
+  , m_roundClosed(true)
+  , m_maxFrequency(0.0)
+  , m_churnWeight(0.25)
+  , m_churn(0.0)
+  , m_handoverMargin(0)
+  , m_keepSupernode(false)
+  , m_cpu(1.0)
+  , m_ram(1.0)
+  , m_load(0.0)
+  , m_linkCapacity(0.0)
+  , m_weightDegree(1.0)
+  , m_weightCpu(0.0)
+  , m_weightRam(0.0)
+  , m_weightLink(0.0)
+  , m_weightLoad(0.0)
+  , m_loadThreshold(0.0)
+  , m_maxMembers(0)
+  , m_maxMergeRate(0.0)
+  , m_retired(false)
+  , m_lastMerges(0)
+  , m_maxDomainSize(0)
+  , m_minDomainSize(0)
+  , m_election("degree")
+  , m_span(NeighbourhoodInfo::UNKNOWN)
+  , m_k(1)
+  , m_maxLevel(1)
+  , m_filterReach(1)
+  , m_level(0)
+  , m_doubleDomination(false)
+  , m_backupId(NeighbourhoodInfo::UNKNOWN)
+  , m_backupFace(0)
+  , m_supernodeId(std::numeric_limits<uint32_t>::max())
+  , m_supernodeFace(0)
+  , m_quiesced(false)
+  , m_warmStart(false)
+  , m_neighbourhoodChanged(false)
+{
+  m_seqMax = std::numeric_limits<uint32_t>::max();
+}
+
+Clusterconsumer::~Clusterconsumer()
+{
+}
+
+Ptr<Clusterconsumer>
+Clusterconsumer::GetClusterconsumer(Ptr<Node> node)
+{
+  for (uint32_t i = 0; i < node->GetNApplications(); i++) {
+    Ptr<Clusterconsumer> consumer = DynamicCast<Clusterconsumer>(node->GetApplication(i));
+    if (consumer != 0)
+      return consumer;
+  }
+  return 0;
+}
+
+void
+Clusterconsumer::BecomeSupernode(uint32_t face)
+{
+  if (IsSupernode()) {
+    NS_LOG_INFO("Already a Supernode");
+    return;
+  }
+
+  if (m_retired) {
+    NS_LOG_INFO("Supernode again");
+    m_retired = false;
+    if (!m_quiesced)
+      DynamicCast<Supernode>(m_supernode)->Resume();
+    this->GetNode()->SetSupernodeFace(face);
+    m_supernodeId = this->GetNode()->GetId();
+    m_supernodeFace = face;
+    m_roleChanged(this->GetNode()->GetId(), true);
+    return;
+  }
+
+  NS_LOG_INFO("Transforming into Supernode");
+  m_supernode = CreateObject<Supernode>();
+  this->GetNode()->AddApplication(m_supernode);
+  this->GetNode()->SetAsSupernode();
+  this->GetNode()->SetSupernodeFace(face);
+  m_supernodeId = this->GetNode()->GetId();
+  m_supernodeFace = face;
+  m_level = 1;
+
+  if (m_quiesced)
+    DynamicCast<Supernode>(m_supernode)->Quiesce();
+
+  m_roleChanged(this->GetNode()->GetId(), true);
+}
+
+bool
+Clusterconsumer::IsSupernode() const
+{
+  return this->GetNode()->IsSupernode() && !m_retired;
+}
+
+bool
+Clusterconsumer::InRotationCooldown() const
+{
+  return m_retired && Simulator::Now() < m_lastRotation + m_rotationCooldown;
+}
+
+void
+Clusterconsumer::CountMember(uint32_t memberId)
+{
+  if (memberId != this->GetNode()->GetId())
+    m_members.insert(memberId);
+}
+
+bool
+Clusterconsumer::AdmitMember(uint32_t memberId, bool force)
+{
+  if (memberId == this->GetNode()->GetId())
+    return true;
+
+  // members leave silently when they join elsewhere
+  Time expiry = Seconds(m_missedRounds / m_frequency);
+  for (auto it = m_domainMembers.begin(); it != m_domainMembers.end();) {
+    if (Simulator::Now() - it->second > expiry)
+      it = m_domainMembers.erase(it);
+    else
+      ++it;
+  }
+
+  if (!force && m_maxDomainSize > 0 && m_domainMembers.count(memberId) == 0
+      && m_domainMembers.size() >= m_maxDomainSize) {
+    NS_LOG_INFO("Domain full with " << m_domainMembers.size() << " members, refused "
+                << memberId);
+    return false;
+  }
+
+  m_domainMembers[memberId] = Simulator::Now();
+  CountMember(memberId);
+  return true;
+}
+
+uint32_t
+Clusterconsumer::GetDomainSize() const
+{
+  Time expiry = Seconds(m_missedRounds / m_frequency);
+  uint32_t size = 0;
+  for (const auto& member : m_domainMembers) {
+    if (Simulator::Now() - member.second <= expiry)
+      size++;
+  }
+  return size;
+}
+
+void
+Clusterconsumer::UpdateLoad()
+{
+  Time elapsed = Simulator::Now() - m_lastLoadUpdate;
+  m_lastLoadUpdate = Simulator::Now();
+  if (m_maxMembers == 0 && m_maxMergeRate <= 0)
+    return; // Load stays as configured
+
+  double load = 0.0;
+  if (IsSupernode()) {
+    if (m_maxMembers > 0)
+      load = std::max(load, static_cast<double>(m_members.size()) / m_maxMembers);
+
+    uint64_t merges = DynamicCast<Supernode>(m_supernode)->GetMergeCount();
+    if (m_maxMergeRate > 0 && elapsed.IsStrictlyPositive())
+      load = std::max(load, (merges - m_lastMerges) / elapsed.GetSeconds() / m_maxMergeRate);
+    m_lastMerges = merges;
+  }
+  m_members.clear();
+  m_load = std::min(load, 1.0);
+
+  if (IsSupernode() && m_loadThreshold > 0 && m_load >= m_loadThreshold && m_handovers.empty()
+      && Simulator::Now() >= m_lastRotation + m_rotationCooldown)
+    HandOver();
+}
+
+void
+Clusterconsumer::HandOver()
+{
+  // most capable neighbour that answered this round, its score already reflects its load
+  auto successor = m_neighbourhood.end();
+  for (auto it = m_neighbourhood.begin(); it != m_neighbourhood.end(); ++it) {
+    const NeighbourhoodInfo& info = it->second.info;
+    if ((info.flags & NeighbourhoodInfo::SUPERNODE) || it->second.round != m_round)
+      continue;
+    if (successor == m_neighbourhood.end() || info.score > successor->second.info.score
+        || (info.score == successor->second.info.score && it->first > successor->first))
+      successor = it;
+  }
+
+  if (successor == m_neighbourhood.end() || successor->second.info.score <= GetScore()) {
+    NS_LOG_DEBUG("Load " << m_load << ", but no neighbour could take over");
+    return;
+  }
+
+  uint32_t self = this->GetNode()->GetId();
+  uint32_t seq = m_seq++;
+  const bloom_filter& filter = DynamicCast<Supernode>(m_supernode)->GetDomainFilter();
+
+  // /localhop/Cluster/SHO/<from>/<to>/<seq>
+  shared_ptr<Name> nameWithSequence = make_shared<Name>("ndn:/localhop/Cluster/SHO");
+  nameWithSequence->appendNumber(self);
+  nameWithSequence->appendNumber(successor->first);
+  nameWithSequence->appendSequenceNumber(seq);
+
+  shared_ptr<Interest> interest = make_shared<Interest>();
+  interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
+  interest->setName(*nameWithSequence);
+  time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
+  interest->setInterestLifetime(interestLifeTime);
+  interest->setBfComponents(filter.size(), filter.table(), filter.element_count(), filter.salt_count());
+
+  shared_ptr<ndn::lp::NextHopFaceIdTag> tag = make_shared<ndn::lp::NextHopFaceIdTag>(successor->second.face);
+  interest->setTag(tag);
+
+  NS_LOG_INFO("Load " << m_load << ", handing the supernode role to Node " << successor->first);
+  m_handovers[seq] = successor->first;
+
+  WillSendOutInterest(seq);
+
+  m_transmittedInterests(interest, this, m_face);
+  m_appLink->onReceiveInterest(*interest);
+}
+
+void
+Clusterconsumer::AcceptHandover(uint32_t from, uint32_t face, const bloom_filter& filter)
+{
+  NS_LOG_INFO("Taking over the supernode role of " << from);
+  BecomeSupernode(face);
+  if (m_supernode != 0)
+    DynamicCast<Supernode>(m_supernode)->MergeFilter(filter);
+}
+
+void
+Clusterconsumer::Retire(uint32_t successorId, uint32_t face)
+{
+  uint32_t self = this->GetNode()->GetId();
+  NS_LOG_INFO("Handed the supernode role to " << successorId);
+
+  m_retired = true;
+  m_lastRotation = Simulator::Now();
+  DynamicCast<Supernode>(m_supernode)->Quiesce();
+  m_roleChanged(self, false);
+  m_handedOver(self, successorId, m_load);
+
+  SetSupernodeFace(successorId, face);
+
+  // members learn it from the next CII replies, a repair makes that now
+  Repair(m_repairHops);
+}
+
+void
+Clusterconsumer::SetSupernodeFace(uint32_t supernodeId, uint32_t face)
+{
+  NS_LOG_INFO("Setting node " << supernodeId << " as it's Supernode through face " << face);
+  this->GetNode()->SetSupernodeFace(face);
+
+  if (supernodeId == m_supernodeId && face == m_supernodeFace)
+    return; // periodic SCI confirming the current supernode
+
+  m_supernodeId = supernodeId;
+  m_supernodeFace = face;
+  m_supernodeChanged(this->GetNode()->GetId(), supernodeId, face);
+}
+
+void
+Clusterconsumer::Quiesce()
+{
+  NS_LOG_FUNCTION_NOARGS();
+
+  m_quiesced = true;
+  Simulator::Cancel(m_sendEvent);
+
+  if (m_supernode != 0)
+    DynamicCast<Supernode>(m_supernode)->Quiesce();
+}
+
+bool
+Clusterconsumer::CanQuiesce() const
+{
+  if (!m_services.empty())
+    return false;
+  return m_supernode == 0 || !DynamicCast<Supernode>(m_supernode)->HasUpkeep();
+}
+
+uint32_t
+Clusterconsumer::GetSupernodeId() const
+{
+  return m_supernodeId;
+}
+
+uint32_t
+Clusterconsumer::GetSupernodeFace() const
+{
+  return m_supernodeFace;
+}
+
+const bloom_filter*
+Clusterconsumer::GetDomainFilter() const
+{
+  if (m_supernode == 0 || m_retired)
+    return 0;
+  return &DynamicCast<Supernode>(m_supernode)->GetDomainFilter();
+}
+
+void
+Clusterconsumer::ReceiveSupernodeFilter(uint32_t supernodeId, uint32_t face, const bloom_filter& filter)
+{
+  if (supernodeId == this->GetNode()->GetId())
+    return;
+
+  SupernodeFilter& entry = m_supernodeFilters[supernodeId];
+  entry.face = face;
+  entry.filter = filter;
+}
+
+const std::map<uint32_t, Clusterconsumer::SupernodeFilter>&
+Clusterconsumer::GetSupernodeFilters() const
+{
+  return m_supernodeFilters;
+}
+
+void
+Clusterconsumer::ReceiveSupernodeShard(uint32_t supernodeId, uint32_t face, uint32_t shard,
+                                       uint64_t capacity, const bloom_filter& filter)
+{
+  if (supernodeId == this->GetNode()->GetId())
+    return;
+
+  SupernodeFilter& entry = m_supernodeFilters[supernodeId];
+  entry.face = face;
+  entry.shards[shard] = filter;
+  if (supernodeId == m_supernodeId)
+    m_shardCapacities[shard] = capacity;
+}
+
+const bloom_filter*
+Clusterconsumer::GetDomainShard(uint32_t shard) const
+{
+  if (m_supernode == 0 || !IsSupernode())
+    return 0;
+  return DynamicCast<Supernode>(m_supernode)->GetShards().Get(shard);
+}
+
+std::vector<uint32_t>
+Clusterconsumer::GetMemberFaces() const
+{
+  std::vector<uint32_t> faces;
+  uint32_t self = this->GetNode()->GetId();
+  for (const auto& neighbour : m_neighbourhood) {
+    if (neighbour.second.info.supernodeId == self)
+      faces.push_back(neighbour.second.face);
+  }
+  return faces;
+}
+
+uint32_t
+Clusterconsumer::GetSupernodeDistance(uint32_t supernodeId) const
+{
+  auto route = m_supernodeRoutes.find(supernodeId);
+  if (route != m_supernodeRoutes.end())
+    return route->second.distance;
+  return m_neighbourhood.count(supernodeId) > 0 ? 1 : NeighbourhoodInfo::UNKNOWN;
+}
+
+void
+Clusterconsumer::RequestFilterRebuild(uint32_t supernodeId, uint32_t face)
+{
+  uint32_t seq = m_seq++;
+
+  // /localhop/Cluster/FRR/<origin>/<supernode>/<seq>
+  shared_ptr<Name> nameWithSequence = make_shared<Name>("ndn:/localhop/Cluster/FRR");
+  nameWithSequence->appendNumber(this->GetNode()->GetId());
+  nameWithSequence->appendNumber(supernodeId);
+  nameWithSequence->appendSequenceNumber(seq);
+
+  shared_ptr<Interest> interest = make_shared<Interest>();
+  interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
+  interest->setName(*nameWithSequence);
+  time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
+  interest->setInterestLifetime(interestLifeTime);
+
+  shared_ptr<ndn::lp::NextHopFaceIdTag> tag = make_shared<ndn::lp::NextHopFaceIdTag>(face);
+  interest->setTag(tag);
+
+  NS_LOG_INFO("Asking Node " << supernodeId << " to rebuild its domain filter");
+
+  WillSendOutInterest(seq);
+
+  m_transmittedInterests(interest, this, m_face);
+  m_appLink->onReceiveInterest(*interest);
+}
+
+void
+Clusterconsumer::RebuildFilter(uint32_t origin)
+{
+  NS_LOG_INFO("Node " << origin << " finds the domain filter noisy");
+  if (m_supernode != 0)
+    DynamicCast<Supernode>(m_supernode)->Rebuild();
+}
+
+void
+Clusterconsumer::AdvertiseService(const Name& service)
+{
+  NS_LOG_INFO("Advertising " << service << " at Cpu class " << ResourceClass::Quantise(m_cpu)
+              << ", Ram class " << ResourceClass::Quantise(m_ram));
+  if (std::find(m_services.begin(), m_services.end(), service) == m_services.end())
+    m_services.push_back(service);
+}
+
+bool
+Clusterconsumer::HasService(const Name& service, uint32_t minCpuClass, uint32_t minRamClass) const
+{
+  const bloom_filter* shard = GetDomainShard(ShardedFilter::GetShard(service));
+  return shard != 0 && ResourceClass::Contains(*shard, service, minCpuClass, minRamClass);
+}
+
+void
+Clusterconsumer::SendServiceFilter()
+{
+  uint32_t self = this->GetNode()->GetId();
+  bool isSupernode = IsSupernode();
+  if (!isSupernode && m_supernodeFace == 0)
+    return; // no supernode yet
+
+  // one filter per shard, at the capacity the supernode announced for it
+  std::map<uint32_t, bloom_filter> filters;
+  for (const Name& service : m_services) {
+    uint32_t shard = ShardedFilter::GetShard(service);
+    auto filter = filters.find(shard);
+    if (filter == filters.end()) {
+      uint64_t capacity = ShardedFilter::MIN_CAPACITY;
+      if (isSupernode)
+        capacity = DynamicCast<Supernode>(m_supernode)->GetShards().GetCapacity(shard);
+      else if (m_shardCapacities.count(shard) > 0)
+        capacity = m_shardCapacities[shard];
+      filter = filters.emplace(shard, ShardedFilter::MakeShape(capacity)).first;
+    }
+    ResourceClass::Insert(filter->second, service, m_cpu, m_ram);
+  }
+
+  uint32_t distance = GetSupernodeDistance(m_supernodeId);
+  uint32_t ttl = distance != NeighbourhoodInfo::UNKNOWN && distance > 0 ? distance - 1 : 0;
+  for (const auto& filter : filters) {
+    if (isSupernode)
+      ReceiveServiceFilter(self, 0, filter.first, filter.second);
+    else
+      SendServiceFilter(self, m_supernodeId, m_supernodeFace, ttl, filter.first, filter.second);
+  }
+}
+
+bool
+Clusterconsumer::RelayServiceFilter(uint32_t origin, uint32_t supernodeId, uint32_t ttl,
+                                    uint32_t shard, const bloom_filter& filter)
+{
+  uint32_t distance = GetSupernodeDistance(supernodeId);
+  if (distance == NeighbourhoodInfo::UNKNOWN || distance > ttl)
+    return false;
+
+  auto route = m_supernodeRoutes.find(supernodeId);
+  uint32_t face = route != m_supernodeRoutes.end() ? route->second.face
+                                                   : m_neighbourhood[supernodeId].face;
+  SendServiceFilter(origin, supernodeId, face, distance - 1, shard, filter);
+  return true;
+}
+
+void
+Clusterconsumer::ReceiveServiceFilter(uint32_t origin, uint32_t face, uint32_t shard,
+                                      const bloom_filter& filter)
+{
+  // a relayed filter arrives on the face of the relay, not the member's
+  auto member = m_neighbourhood.find(origin);
+  if (member != m_neighbourhood.end() && member->second.face == face) {
+    SupernodeFilter& entry = m_memberServiceFilters[origin];
+    entry.face = face;
+    entry.shards[shard] = filter;
+  }
+
+  if (m_supernode != 0)
+    DynamicCast<Supernode>(m_supernode)->MergeShard(shard, filter);
+}
+
+const std::map<uint32_t, Clusterconsumer::SupernodeFilter>&
+Clusterconsumer::GetMemberServiceFilters() const
+{
+  return m_memberServiceFilters;
+}
+
+void
+Clusterconsumer::SendServiceFilter(uint32_t origin, uint32_t supernodeId, uint32_t face,
+                                   uint32_t ttl, uint32_t shard, const bloom_filter& filter)
+{
+  uint32_t seq = m_seq++;
+
+  // /localhop/Cluster/RES/<origin>/<supernode>/<ttl>/<shard>/<seq>
+  shared_ptr<Name> nameWithSequence = make_shared<Name>("ndn:/localhop/Cluster/RES");
+  nameWithSequence->appendNumber(origin);
+  nameWithSequence->appendNumber(supernodeId);
+  nameWithSequence->appendNumber(ttl);
+  nameWithSequence->appendNumber(shard);
+  nameWithSequence->appendSequenceNumber(seq);
+
+  shared_ptr<Interest> interest = make_shared<Interest>();
+  interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
+  interest->setName(*nameWithSequence);
+  time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
+  interest->setInterestLifetime(interestLifeTime);
+  interest->setBfComponents(filter.size(), filter.table(), filter.element_count(), filter.salt_count());
+
+  shared_ptr<ndn::lp::NextHopFaceIdTag> tag = make_shared<ndn::lp::NextHopFaceIdTag>(face);
+  interest->setTag(tag);
+
+  NS_LOG_INFO("Sending shard " << shard << " of the service filter of " << origin << " to Node "
+              << supernodeId);
+
+  WillSendOutInterest(seq);
+
+  m_transmittedInterests(interest, this, m_face);
+  m_appLink->onReceiveInterest(*interest);
+}
+
+void
+Clusterconsumer::WarmStart(uint32_t supernodeId, uint32_t face, const bloom_filter* domainFilter)
+{
+  if (supernodeId == std::numeric_limits<uint32_t>::max())
+    return; // never joined a domain, so it runs the election as usual
+
+  m_warmStart = true;
+
+  if (supernodeId == this->GetNode()->GetId()) {
+    BecomeSupernode(face);
+    if (m_supernode != 0 && domainFilter != 0)
+      DynamicCast<Supernode>(m_supernode)->SetDomainFilter(*domainFilter);
+  }
+  else {
+    SetSupernodeFace(supernodeId, face);
+  }
+}
+
+NeighbourhoodInfo
+Clusterconsumer::GetNeighbourhoodInfo() const
+{
+  NeighbourhoodInfo info;
+  info.supernodeId = m_supernodeId;
+  info.backupId = m_backupId;
+  info.span = m_span;
+  info.score = GetScore();
+  info.domainSize = IsSupernode() ? GetDomainSize() : 0;
+  info.flags = IsSupernode() ? NeighbourhoodInfo::SUPERNODE : 0;
+
+  info.neighbours.reserve(m_neighbourhood.size());
+  for (const auto& neighbour : m_neighbourhood)
+    info.neighbours.push_back(neighbour.first);
+
+  // supernodes one more hop away are still within K of the receiver
+  if (IsSupernode())
+    info.supernodes.push_back(std::make_pair(this->GetNode()->GetId(), 0));
+  for (const auto& route : m_supernodeRoutes) {
+    if (route.second.distance < m_k)
+      info.supernodes.push_back(std::make_pair(route.first, route.second.distance));
+  }
+  std::sort(info.supernodes.begin(), info.supernodes.end());
+  info.candidates = m_candidates;
+
+  // the overlay state is sized when the application starts
+  uint32_t self = this->GetNode()->GetId();
+  for (uint32_t level = 1; level <= m_level && level < m_parents.size(); level++) {
+    NeighbourhoodInfo::OverlayEntry entry = {level, self, 0, m_overlaySpans[level], m_parents[level]};
+    info.overlay.push_back(entry);
+  }
+  for (const auto& route : m_overlayRoutes) {
+    if (route.second.distance < GetOverlayRadius(route.first.first)) {
+      NeighbourhoodInfo::OverlayEntry entry = {route.first.first, route.first.second,
+                                               route.second.distance, route.second.span,
+                                               route.second.parent};
+      info.overlay.push_back(entry);
+    }
+  }
+  std::sort(info.overlay.begin(), info.overlay.end());
+
+  return info;
+}
+
+// Application Methods
+void
+Clusterconsumer::StartApplication() // Called at time specified by Start
+{
+  NS_LOG_FUNCTION_NOARGS();
+
+  // do base stuff
+  App::StartApplication();
+
+  // Adds own values into neighbouring table
+  best_nId = this->GetNode()->GetId();
+  best_face = 0;
+  best_nN = this->GetNode()->GetNDevices();
+
+  m_parents.assign(m_maxLevel, NeighbourhoodInfo::UNKNOWN);
+  m_overlaySpans.assign(m_maxLevel, NeighbourhoodInfo::UNKNOWN);
+
+  m_linkCapacity = 0.0;
+  for (uint32_t i = 0; i < this->GetNode()->GetNDevices(); i++) {
+    Ptr<NetDevice> device = this->GetNode()->GetDevice(i);
+    device->AddLinkChangeCallback(MakeCallback(&Clusterconsumer::LinkChanged, this));
+
+    DataRateValue rate;
+    if (device->GetAttributeFailSafe("DataRate", rate))
+      m_linkCapacity += rate.Get().GetBitRate() / 1e9;
+  }
+
+  if (m_warmStart) {
+    NS_LOG_INFO("Warm start, skipping election");
+    return;
+  }
+
+  ScheduleNextPacket();
+}
+
+
+void
+Clusterconsumer::ScheduleNextPacket()
+{
+  // double mean = 8.0 * m_payloadSize / m_desiredRate.GetBitRate ();
+  // std::cout << "next: " << Simulator::Now().ToDouble(Time::S) + mean << "s\n";
+
+  if (m_firstTime) {
+    m_sendEvent = Simulator::Schedule(Seconds(0.0), &Clusterconsumer::SendPacket, this);
+    m_firstTime = false;
+  }
+  else if (!m_sendEvent.IsRunning()) {
+    double frequency = GetFrequency();
+    m_sendEvent = Simulator::Schedule((m_random == 0) ? Seconds(1.0 / frequency)
+                                                      : Seconds(m_random->GetValue() * m_frequency / frequency),
+                                      &Clusterconsumer::SendPacket, this);
+  }
+}
+
+double
+Clusterconsumer::GetFrequency() const
+{
+  if (m_maxFrequency <= m_frequency)
+    return m_frequency;
+  return m_frequency + (m_maxFrequency - m_frequency) * m_churn;
+}
+
+uint32_t
+Clusterconsumer::GetScore() const
+{
+  uint32_t degree = m_neighbourhood.empty() ? this->GetNode()->GetNDevices() : m_neighbourhood.size();
+  double score = m_weightDegree * degree + m_weightCpu * m_cpu + m_weightRam * m_ram
+                 + m_weightLink * m_linkCapacity - m_weightLoad * m_load;
+
+  // every node stays electable, so that the weighted election still dominates the graph
+  return static_cast<uint32_t>(std::max(1.0, std::min(std::round(score * 1000), 4e9)));
+}
+
+double
+Clusterconsumer::GetChurn() const
+{
+  return m_churn;
+}
+
+bool
+Clusterconsumer::IsHandover(uint32_t currentScore, uint32_t candidateScore, uint32_t unit) const
+{
+  if (m_keepSupernode)
+    return false;
+  return candidateScore > currentScore + static_cast<uint64_t>(m_handoverMargin) * unit;
+}
+
+bool
+Clusterconsumer::IsRefused(uint32_t supernodeId) const
+{
+  auto refused = m_refused.find(supernodeId);
+  return refused != m_refused.end() && refused->second >= m_round;
+}
+
+bool
+Clusterconsumer::IsFull(const NeighbourhoodInfo& info) const
+{
+  return m_maxDomainSize > 0 && info.domainSize >= m_maxDomainSize;
+}
+
+void
+Clusterconsumer::SendPacket()
+{
+  if (!m_active || m_quiesced)
+    return;
+
+  //NS_LOG_FUNCTION_NOARGS();
+
+  uint32_t seq = std::numeric_limits<uint32_t>::max(); // invalid
+
+  while (m_retxSeqs.size()) {
+    seq = *m_retxSeqs.begin();
+    m_retxSeqs.erase(m_retxSeqs.begin());
+    break;
+  }
+
+  if (seq == std::numeric_limits<uint32_t>::max()) {
+    if (m_seqMax != std::numeric_limits<uint32_t>::max()) {
+      if (m_seq >= m_seqMax) {
+        return; // we are totally done
+      }
+    }
+
+    seq = m_seq++;
+  }
+
+  // the load of the ending period, with the replies of its round
+  UpdateLoad();
+
+  CloseRound(false);
+  SendCii(seq, false, 0);
+
+  if (m_maxLevel > 1)
+    SendAggregates();
+
+  if (m_maxLevel > 1 && m_filterReach > 1)
+    SendDistantFilters();
+
+  if (m_doubleDomination)
+    SendBackupFilters();
+
+  if (!m_services.empty())
+    SendServiceFilter();
+
+  ScheduleNextPacket();
+}
+
+
+void
+Clusterconsumer::SendCii(uint32_t seq, bool repair, uint32_t repairHops)
+{
+  m_round++;
+  m_roundAnswers.clear();
+  m_roundElected = false;
+  m_roundClosed = false;
+  m_repairRound = repair;
+  m_neighbours.clear();
+  best_nId = this->GetNode()->GetId();
+  best_face = 0;
+  best_nN = GetScore();
+
+  // the round makes every CII name unique, the hops tell receivers how far to pass a repair on
+  shared_ptr<Name> nameWithSequence = make_shared<Name>(m_interestName);
+  nameWithSequence->append("CII");
+  nameWithSequence->appendNumber(this->GetNode()->GetId());
+  nameWithSequence->appendNumber(m_round);
+  nameWithSequence->appendNumber(repairHops);
+
+  shared_ptr<Interest> interest = make_shared<Interest>();
+  interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
+  interest->setName(*nameWithSequence);
+  time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
+  interest->setInterestLifetime(interestLifeTime);
+  interest->setCII();
+
+  NS_LOG_INFO("Sending " << interest->getName());
+  
+  WillSendOutInterest(seq);
+
+  m_transmittedInterests(interest, this, m_face);
+  m_appLink->onReceiveInterest(*interest);
+
+  // neighbours that have not answered by then will not
+  Simulator::Cancel(m_roundEvent);
+  m_roundEvent = Simulator::Schedule(m_interestLifeTime, &Clusterconsumer::CloseRound, this, true);
+}
+
+uint32_t
+Clusterconsumer::GetExpectedAnswers() const
+{
+  return m_neighbourhood.empty() ? this->GetNode()->GetNDevices() : m_neighbourhood.size();
+}
+
+void
+Clusterconsumer::CloseRound(bool timedOut)
+{
+  Simulator::Cancel(m_roundEvent);
+  if (m_roundClosed)
+    return;
+  m_roundClosed = true;
+
+  // churn: Jaccard distance between the neighbours answering consecutive periodic rounds
+  if (!m_repairRound) {
+    size_t common = 0;
+    for (uint32_t nodeId : m_roundAnswers)
+      common += m_lastAnswers.count(nodeId);
+    size_t all = m_roundAnswers.size() + m_lastAnswers.size() - common;
+    if (!m_lastAnswers.empty() && all > 0)
+      m_churn += m_churnWeight * ((1.0 - static_cast<double>(common) / all) - m_churn);
+    m_lastAnswers = m_roundAnswers;
+  }
+
+  std::vector<uint32_t> lost;
+  for (const auto& neighbour : m_neighbourhood) {
+    uint32_t missed = m_round - neighbour.second.round;
+    if (missed >= m_missedRounds || (m_repairRound && timedOut && missed > 0))
+      lost.push_back(neighbour.first);
+  }
+  for (uint32_t nodeId : lost)
+    LoseNeighbour(nodeId);
+
+  // a round some neighbour did not answer is elected on the replies it got
+  if ((!m_roundElected && !m_roundAnswers.empty()) || !lost.empty())
+    ElectRound();
+  m_roundElected = true;
+}
+
+void
+Clusterconsumer::LoseNeighbour(uint32_t nodeId)
+{
+  m_supernodeFilters.erase(nodeId);
+  m_memberServiceFilters.erase(nodeId);
+  if (m_supernode != 0 && IsSupernode())
+    DynamicCast<Supernode>(m_supernode)->RemoveMember(nodeId);
+  if (m_neighbourhood.erase(nodeId) == 0)
+    return;
+
+  NS_LOG_INFO("Neighbour " << nodeId << " is gone");
+  m_neighbourhoodChanged = true;
+
+  if (nodeId == m_backupId) {
+    m_backupId = NeighbourhoodInfo::UNKNOWN;
+    m_backupFace = 0;
+  }
+
+  if (nodeId == m_supernodeId && !IsSupernode()) {
+    if (m_doubleDomination && m_backupId != NeighbourhoodInfo::UNKNOWN) {
+      Failover();
+    }
+    else {
+      // undominated again, the next election joins or elects a supernode nearby
+      m_supernodeId = NeighbourhoodInfo::UNKNOWN;
+      m_supernodeFace = 0;
+      m_supernodeChanged(this->GetNode()->GetId(), m_supernodeId, m_supernodeFace);
+    }
+  }
+
+  Repair(m_repairHops);
+}
+
+void
+Clusterconsumer::Repair(uint32_t hops)
+{
+  if (!m_active || m_repairHops == 0)
+    return;
+
+  if (m_repairEvent.IsRunning()) {
+    m_pendingRepair = std::max(m_pendingRepair, hops);
+    return;
+  }
+
+  m_pendingRepair = hops;
+  m_repairEvent = Simulator::Schedule(m_repairDelay, &Clusterconsumer::SendRepair, this);
+}
+
+void
+Clusterconsumer::LinkChanged()
+{
+  NS_LOG_INFO("Link change, repairing");
+  Repair(m_repairHops);
+}
+
+void
+Clusterconsumer::SendRepair()
+{
+  // runs also when quiesced, repairs are not periodic traffic
+  m_repaired(this->GetNode()->GetId(), m_pendingRepair);
+  CloseRound(false);
+  SendCii(m_seq++, true, m_pendingRepair);
+}
+
+void
+Clusterconsumer::ElectRound()
+{
+  m_roundElected = true;
+
+  if (m_k > 1) {
+    ElectKHop(m_localFace);
+  }
+  else if (m_election == "coverage" || m_election == "weighted") {
+    ElectByCoverage(m_localFace);
+  }
+  else {
+    if (best_face == 0)
+    {
+      best_face = m_localFace;
+      NEntry nEntry = {best_nId, best_face, best_nN};
+      m_neighbours.insert(m_neighbours.begin(), nEntry);
+    }
+    BestNeighbour();
+  }
+
+  if (m_maxLevel > 1)
+    ElectOverlay();
+
+  // a repair spreads for as long as it changes what nodes advertise
+  NeighbourhoodInfo info = GetNeighbourhoodInfo();
+  if (m_repairRound && info != m_advertised)
+    Repair(1);
+  m_advertised = info;
+}
+
+void
+Clusterconsumer::SetRandomize(const std::string& value)
+{
+  if (value == "uniform") {
+    m_random = CreateObject<UniformRandomVariable>();
+    m_random->SetAttribute("Min", DoubleValue(0.0));
+    m_random->SetAttribute("Max", DoubleValue(2 * 1.0 / m_frequency));
+  }
+  else if (value == "exponential") {
+    m_random = CreateObject<ExponentialRandomVariable>();
+    m_random->SetAttribute("Mean", DoubleValue(1.0 / m_frequency));
+    m_random->SetAttribute("Bound", DoubleValue(50 * 1.0 / m_frequency));
+  }
+  else
+    m_random = 0;
+
+  m_randomType = value;
+}
+
+std::string
+Clusterconsumer::GetRandomize() const
+{
+  return m_randomType;
+}
+
+
+void
+Clusterconsumer::OnData(shared_ptr<const Data> data)
+{
+  if (!m_active)
+    return;
+
+  App::OnData(data); // tracing inside
+
+  NS_LOG_INFO(data->getName() << " from " << data->getNodeId() << " received");
+
+  uint32_t seq = 0;
+
+  int hopCount = 0;
+  auto hopCountTag = data->getTag<lp::HopCountTag>();
+  if (hopCountTag != nullptr) { // e.g., packet came from local node's cache
+    hopCount = *hopCountTag;
+  }
+
+  SeqTimeoutsContainer::iterator entry = m_seqLastDelay.find(seq);
+  if (entry != m_seqLastDelay.end()) {
+    m_lastRetransmittedInterestDataDelay(this, seq, Simulator::Now() - entry->time, hopCount);
+  }
+
+  entry = m_seqFullDelay.find(seq);
+  if (entry != m_seqFullDelay.end()) {
+    m_firstInterestDataDelay(this, seq, Simulator::Now() - entry->time, m_seqRetxCounts[seq], hopCount);
+  }
+
+  m_seqRetxCounts.erase(seq);
+  m_seqFullDelay.erase(seq);
+  m_seqLastDelay.erase(seq);
+
+  m_seqTimeouts.erase(seq);
+  m_retxSeqs.erase(seq);
+
+  m_rtt->AckSeq(SequenceNumber32(seq));
+
+  // When a data with neighbours is received, the data is stored in a list
+  if (data->getNeighbours() > 0) {
+    m_roundAnswers.insert(data->getNodeId());
+    m_localFace = data->getSCIFace();
+
+    Neighbour& neighbour = m_neighbourhood[data->getNodeId()];
+    neighbour.round = m_round;
+    NeighbourhoodInfo info;
+    const Block& content = data->getContent();
+    if (info.Decode(content.value(), content.value_size())) {
+      m_neighbourhoodChanged |= neighbour.face != data->getFaceId() || neighbour.info != info;
+      neighbour.face = data->getFaceId();
+      neighbour.info = info;
+      if ((info.flags & NeighbourhoodInfo::SUPERNODE) == 0)
+        m_supernodeFilters.erase(data->getNodeId()); // stepped down
+    }
+    else {
+      NS_LOG_DEBUG("No neighbourhood information from " << data->getNodeId());
+      neighbour.face = data->getFaceId();
+    }
+
+    NEntry nEntry = {data->getNodeId(), data->getFaceId(), data->getNeighbours()};
+    m_neighbours.push_back(nEntry);
+    // best score, ties to the higher id; neighbours without one count by their degree
+    uint32_t score = neighbour.info.score > 0 ? neighbour.info.score : data->getNeighbours() * 1000;
+    if (score > best_nN || (score == best_nN && data->getNodeId() > best_nId)) {
+      best_nId = data->getNodeId();
+      best_face = data->getFaceId();
+      best_nN = score;
+    }
+    
+
+    // Once every known neighbour answered this round; a round with silent neighbours is
+    // elected when it closes
+    if (!m_roundElected && m_roundAnswers.size() >= GetExpectedAnswers())
+      ElectRound();
+  }
+
+  if (Name("/localhop/Cluster/SHO").isPrefixOf(data->getName()) && data->getName().size() > 5) {
+    auto handover = m_handovers.find(data->getName().at(5).toSequenceNumber());
+    if (handover != m_handovers.end()) {
+      uint32_t successorId = handover->second;
+      m_handovers.erase(handover);
+      if (IsSupernode())
+        Retire(successorId, data->getFaceId());
+    }
+    return;
+  }
+
+  uint32_t sciRole = SCI_PRIMARY;
+  if (data->isSCI() && data->getName().size() > 8) {
+    uint32_t sciSeq = data->getName().at(8).toSequenceNumber();
+    sciRole = data->getName().at(6).toNumber();
+    m_seqTimeouts.erase(sciSeq);
+    m_sciSupernodes.erase(sciSeq);
+  }
+
+  if (data->isSCI() && data->getName().size() > 3
+      && data->getName().at(3).toNumber() != this->GetNode()->GetId()) {
+    NS_LOG_DEBUG("Relayed SCI confirmed by " << data->getNodeId());
+  }
+  else if (data->isSCI() && sciRole == SCI_PRIMARY && data->getContent().value_size() == 1
+           && data->getContent().value()[0] == SCI_REFUSED) {
+    // the domain is full: avoid the supernode for MissedRounds rounds, fall back to the next best
+    NS_LOG_INFO("Supernode " << data->getNodeId() << " refused, domain full");
+    m_refused[data->getNodeId()] = m_round + m_missedRounds;
+    if (m_supernodeId == data->getNodeId()) {
+      m_supernodeId = NeighbourhoodInfo::UNKNOWN;
+      m_supernodeFace = 0;
+      m_supernodeChanged(this->GetNode()->GetId(), m_supernodeId, m_supernodeFace);
+    }
+    if (!IsSupernode() && (m_k > 1 || m_election != "degree"))
+      ElectRound();
+  }
+  else if (data->isSCI() && sciRole == SCI_BACKUP) {
+    NS_LOG_DEBUG("Secondary supernode " << data->getNodeId() << " confirmed");
+  }
+  else if (data->isSCI()) {
+    SetSupernodeFace(data->getNodeId(), data->getFaceId());
+  }
+}
+
+void Clusterconsumer::BestNeighbour()
+{
+  for (std::vector<NEntry>::iterator it = m_neighbours.begin() ; it != m_neighbours.end(); ++it)
+    NS_LOG_DEBUG("Node= " << (*it).getNodeId() << ", Face= " << (*it).getFaceId() << ", Neighbours= " << (*it).getNeighbours());
+
+  // stay with the current supernode while it answers, unless the best beats it by HandoverMargin
+  auto current = m_neighbourhood.find(m_supernodeId);
+  if (current != m_neighbourhood.end() && current->second.round == m_round
+      && current->first != best_nId && !IsHandover(current->second.info.score, best_nN, 1000)) {
+    best_nId = current->first;
+    best_face = current->second.face;
+    best_nN = current->second.info.score;
+  }
+
+  if (best_nId == this->GetNode()->GetId()) {
+    NS_LOG_INFO("This node is best with score " << best_nN);
+
+    BecomeSupernode(best_face);
+  } else {
+    NS_LOG_INFO("Best neighbour is Node " << best_nId << " with score " << best_nN);
+    SendSupernode(best_nId, best_face, 0, this->GetNode()->GetId());
+  }
+}
+
+uint32_t
+Clusterconsumer::GetSpan() const
+{
+  const uint32_t UNKNOWN = NeighbourhoodInfo::UNKNOWN;
+
+  // a node that just handed its role over does not run again, and does not hold others back
+  if (InRotationCooldown())
+    return 0;
+
+  if (!m_doubleDomination) {
+    uint32_t span = m_supernodeId == UNKNOWN;
+    for (const auto& neighbour : m_neighbourhood)
+      span += neighbour.second.info.supernodeId == UNKNOWN;
+    return span;
+  }
+
+  // missing supernodes: min(2, degree) of them are needed unless the node is one itself
+  auto deficit = [] (bool isSupernode, size_t degree, uint32_t primary, uint32_t backup) {
+    if (isSupernode)
+      return 0u;
+    uint32_t needed = std::min<size_t>(2, degree);
+    uint32_t have = (primary != UNKNOWN) + (backup != UNKNOWN);
+    return needed > have ? needed - have : 0u;
+  };
+
+  uint32_t span = deficit(IsSupernode(), m_neighbourhood.size(), m_supernodeId,
+                          m_backupId);
+  for (const auto& neighbour : m_neighbourhood) {
+    const NeighbourhoodInfo& info = neighbour.second.info;
+    span += deficit(info.flags & NeighbourhoodInfo::SUPERNODE, info.neighbours.size(),
+                    info.supernodeId, info.backupId);
+  }
+  return span;
+}
+
+void
+Clusterconsumer::ElectByCoverage(uint32_t localFace)
+{
+  uint32_t self = this->GetNode()->GetId();
+  m_span = GetSpan();
+
+  if (IsSupernode())
+    return;
+
+  // Locally greedy: elected if no neighbour covers more, which needs every neighbour's span.
+  // The weighted election ranks by span times score instead.
+  bool weighted = m_election == "weighted";
+  uint64_t rank = weighted ? static_cast<uint64_t>(m_span) * GetScore() : m_span;
+  bool elected = m_span > 0;
+  for (auto it = m_neighbourhood.begin(); it != m_neighbourhood.end() && elected; ++it) {
+    const NeighbourhoodInfo& info = it->second.info;
+    // with DoubleDomination a supernode may keep a deficit only another node can fill
+    if (m_doubleDomination && (info.flags & NeighbourhoodInfo::SUPERNODE))
+      continue;
+    uint64_t other = weighted ? static_cast<uint64_t>(info.span) * std::max(info.score, 1u) : info.span;
+    elected = info.span != NeighbourhoodInfo::UNKNOWN
+              && (other < rank || (other == rank && it->first < self));
+  }
+
+  if (elected) {
+    NS_LOG_INFO("This node is best with " << m_span << " uncovered nodes, rank " << rank);
+    BecomeSupernode(localFace);
+    return;
+  }
+
+  // Join the adjacent supernode with the most neighbours, staying with the current one while
+  // it is a neighbour unless the other beats it by HandoverMargin. Full domains and recent
+  // refusals are skipped, domains below MinDomainSize go first.
+  auto joinRank = [this](const NeighbourhoodInfo& info) {
+    return std::make_pair(info.domainSize < m_minDomainSize, info.neighbours.size());
+  };
+  auto best = m_neighbourhood.end();
+  auto current = m_neighbourhood.end();
+  for (auto it = m_neighbourhood.begin(); it != m_neighbourhood.end(); ++it) {
+    if ((it->second.info.flags & NeighbourhoodInfo::SUPERNODE) == 0)
+      continue;
+    if (it->first == m_supernodeId)
+      current = it;
+    else if (IsRefused(it->first) || IsFull(it->second.info))
+      continue;
+    if (best == m_neighbourhood.end() || joinRank(it->second.info) > joinRank(best->second.info))
+      best = it;
+  }
+  if (current != m_neighbourhood.end()
+      && !IsHandover(current->second.info.neighbours.size(), best->second.info.neighbours.size()))
+    best = current;
+
+  // the current supernode answered without the supernode flag: it handed its role over
+  auto previous = m_neighbourhood.find(m_supernodeId);
+  if (current == m_neighbourhood.end() && previous != m_neighbourhood.end()
+      && previous->second.round == m_round) {
+    NS_LOG_INFO("Supernode " << m_supernodeId << " stepped down");
+    m_supernodeId = NeighbourhoodInfo::UNKNOWN;
+    m_supernodeFace = 0;
+    m_supernodeChanged(self, m_supernodeId, m_supernodeFace);
+  }
+
+  if (best == m_neighbourhood.end()) {
+    NS_LOG_DEBUG("No supernode in range yet, " << m_span << " uncovered nodes");
+    return;
+  }
+
+  best_nId = best->first;
+  best_face = best->second.face;
+  best_nN = best->second.info.neighbours.size();
+
+  if (m_doubleDomination) {
+    SelectBackup();
+    SendSupernode(best_nId, best_face, 0, self, SCI_PRIMARY, m_backupId);
+    if (m_backupId != NeighbourhoodInfo::UNKNOWN)
+      SendSupernode(m_backupId, m_backupFace, 0, self, SCI_BACKUP, best_nId);
+    return;
+  }
+
+  SendSupernode(best_nId, best_face, 0, self);
+}
+
+void
+Clusterconsumer::SelectBackup()
+{
+  auto backup = m_neighbourhood.end();
+  for (auto it = m_neighbourhood.begin(); it != m_neighbourhood.end(); ++it) {
+    if ((it->second.info.flags & NeighbourhoodInfo::SUPERNODE) == 0 || it->first == best_nId)
+      continue;
+    if (it->first == m_backupId) {
+      backup = it;
+      break;
+    }
+    if (backup == m_neighbourhood.end() || it->second.info.neighbours.size() > backup->second.info.neighbours.size())
+      backup = it;
+  }
+
+  uint32_t backupId = backup == m_neighbourhood.end() ? NeighbourhoodInfo::UNKNOWN : backup->first;
+  if (backupId != m_backupId)
+    NS_LOG_INFO("Secondary supernode " << backupId);
+  m_backupId = backupId;
+  m_backupFace = backup == m_neighbourhood.end() ? 0 : backup->second.face;
+}
+
+void
+Clusterconsumer::Failover()
+{
+  uint32_t self = this->GetNode()->GetId();
+  uint32_t failedId = m_supernodeId;
+  uint32_t backupId = m_backupId;
+  uint32_t backupFace = m_backupFace;
+
+  NS_LOG_INFO("Supernode " << failedId << " does not answer, failing over to " << backupId);
+
+  // forget the failed supernode until it answers a CII again
+  m_neighbourhood.erase(failedId);
+  m_backupId = NeighbourhoodInfo::UNKNOWN;
+  m_backupFace = 0;
+
+  best_nId = backupId;
+  best_face = backupFace;
+  SetSupernodeFace(backupId, backupFace);
+  m_failover(self, failedId, backupId);
+
+  SendSupernode(backupId, backupFace, 0, self, SCI_FAILOVER, failedId);
+}
+
+void
+Clusterconsumer::OnTimeout(uint32_t sequenceNumber)
+{
+  if (m_handovers.erase(sequenceNumber) > 0) {
+    NS_LOG_DEBUG("Handover not confirmed, staying a supernode");
+    return;
+  }
+
+  auto sci = m_sciSupernodes.find(sequenceNumber);
+  if (sci == m_sciSupernodes.end()) {
+    Consumer::OnTimeout(sequenceNumber);
+    return;
+  }
+
+  uint32_t supernodeId = sci->second;
+  m_sciSupernodes.erase(sci);
+  if (supernodeId == m_supernodeId && m_backupId != NeighbourhoodInfo::UNKNOWN
+      && !IsSupernode())
+    Failover();
+}
+
+uint32_t
+Clusterconsumer::GetBackupId() const
+{
+  return m_backupId;
+}
+
+void
+Clusterconsumer::SetMemberBackup(uint32_t backupId, uint32_t face)
+{
+  if (backupId != this->GetNode()->GetId())
+    m_memberBackups[backupId] = face;
+}
+
+void
+Clusterconsumer::SendBackupFilters()
+{
+  if (m_supernode == 0)
+    return;
+
+  const bloom_filter& filter = DynamicCast<Supernode>(m_supernode)->GetDomainFilter();
+  for (const auto& backup : m_memberBackups)
+    SendBackupFilter(this->GetNode()->GetId(), backup.first, backup.second, filter);
+}
+
+bool
+Clusterconsumer::RelayBackupFilter(uint32_t origin, uint32_t backupId, const bloom_filter& filter)
+{
+  auto backup = m_neighbourhood.find(backupId);
+  if (backup == m_neighbourhood.end())
+    return false;
+
+  SendBackupFilter(origin, backupId, backup->second.face, filter);
+  return true;
+}
+
+void
+Clusterconsumer::ReceiveBackupFilter(uint32_t origin, const bloom_filter& filter)
+{
+  if (m_supernode != 0)
+    DynamicCast<Supernode>(m_supernode)->SetBackupFilter(origin, filter);
+}
+
+void
+Clusterconsumer::TakeOver(uint32_t failedId)
+{
+  if (m_supernode != 0)
+    DynamicCast<Supernode>(m_supernode)->TakeOver(failedId);
+}
+
+void
+Clusterconsumer::SendBackupFilter(uint32_t origin, uint32_t backupId, uint32_t face,
+                                  const bloom_filter& filter)
+{
+  uint32_t seq = m_seq++;
+
+  shared_ptr<Name> nameWithSequence = make_shared<Name>("ndn:/localhop/Cluster/BKP");
+  nameWithSequence->appendNumber(origin);
+  nameWithSequence->appendNumber(backupId);
+  nameWithSequence->appendSequenceNumber(seq);
+
+  shared_ptr<Interest> interest = make_shared<Interest>();
+  interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
+  interest->setName(*nameWithSequence);
+  time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
+  interest->setInterestLifetime(interestLifeTime);
+  interest->setBfComponents(filter.size(), filter.table(), filter.element_count(), filter.salt_count());
+
+  shared_ptr<ndn::lp::NextHopFaceIdTag> tag = make_shared<ndn::lp::NextHopFaceIdTag>(face);
+  interest->setTag(tag);
+
+  NS_LOG_INFO("Sending warm filter copy of " << origin << " to Node " << backupId);
+
+  WillSendOutInterest(seq);
+
+  m_transmittedInterests(interest, this, m_face);
+  m_appLink->onReceiveInterest(*interest);
+}
+
+void
+Clusterconsumer::ElectKHop(uint32_t localFace)
+{
+  typedef NeighbourhoodInfo::Candidate Candidate;
+
+  uint32_t self = this->GetNode()->GetId();
+  bool isSupernode = IsSupernode();
+  m_span = GetSpan();
+
+  // distance vector of the supernodes within K hops
+  m_supernodeRoutes.clear();
+  for (const auto& neighbour : m_neighbourhood) {
+    for (const auto& entry : neighbour.second.info.supernodes) {
+      uint32_t distance = entry.second + 1;
+      if (entry.first == self || distance > m_k)
+        continue;
+      auto route = m_supernodeRoutes.find(entry.first);
+      if (route == m_supernodeRoutes.end() || distance < route->second.distance)
+        m_supernodeRoutes[entry.first] = {distance, neighbour.second.face};
+    }
+  }
+
+  // best[d]: best nomination within d hops, built from the neighbours' best within d - 1
+  Candidate own = m_span > 0 && !isSupernode ? Candidate(m_span, self) : Candidate(0, 0);
+  std::vector<Candidate> best(m_k + 1, own);
+  bool complete = true;
+  for (const auto& neighbour : m_neighbourhood) {
+    const NeighbourhoodInfo& info = neighbour.second.info;
+    if (info.span == NeighbourhoodInfo::UNKNOWN || info.candidates.size() != m_k) {
+      complete = false;
+      continue;
+    }
+    for (uint32_t d = 1; d <= m_k; d++)
+      best[d] = std::max(best[d], info.candidates[d - 1]);
+  }
+  for (uint32_t d = 1; d <= m_k; d++)
+    best[d] = std::max(best[d], best[d - 1]);
+  m_candidates.assign(best.begin(), best.end() - 1);
+
+  if (isSupernode)
+    return;
+
+  if (own.first > 0 && complete && best[m_k] == own) {
+    NS_LOG_INFO("This node is best within " << m_k << " hops with " << m_span << " uncovered nodes");
+    BecomeSupernode(localFace);
+    return;
+  }
+
+  // join the nearest supernode, staying with the current one while it is within K hops
+  // unless another is HandoverMargin hops closer
+  auto route = m_supernodeRoutes.end();
+  for (auto it = m_supernodeRoutes.begin(); it != m_supernodeRoutes.end(); ++it) {
+    if (it->first != m_supernodeId && IsRefused(it->first))
+      continue;
+    if (route == m_supernodeRoutes.end() || it->second.distance < route->second.distance)
+      route = it;
+  }
+  auto current = m_supernodeRoutes.find(m_supernodeId);
+  if (current != m_supernodeRoutes.end()
+      && !IsHandover(m_k - current->second.distance, m_k - route->second.distance))
+    route = current;
+
+  if (route == m_supernodeRoutes.end()) {
+    NS_LOG_DEBUG("No supernode within " << m_k << " hops yet, " << m_span << " uncovered nodes");
+    return;
+  }
+
+  best_nId = route->first;
+  best_face = route->second.face;
+  best_nN = route->second.distance;
+  SendSupernode(best_nId, best_face, route->second.distance - 1, self);
+}
+
+bool
+Clusterconsumer::RelaySupernode(uint32_t origin, uint32_t supernodeId, uint32_t ttl)
+{
+  auto route = m_supernodeRoutes.find(supernodeId);
+  if (route == m_supernodeRoutes.end() || route->second.distance > ttl)
+    return false;
+
+  SendSupernode(supernodeId, route->second.face, route->second.distance - 1, origin);
+  return true;
+}
+
+uint32_t
+Clusterconsumer::GetLevel() const
+{
+  return m_level;
+}
+
+uint32_t
+Clusterconsumer::GetOverlayRadius(uint32_t level) const
+{
+  uint32_t radius = m_k;
+  for (uint32_t l = 1; l < level; l++)
+    radius += 2 * radius + 1;
+  return 2 * radius + 1;
+}
+
+void
+Clusterconsumer::ElectOverlay()
+{
+  const uint32_t UNKNOWN = NeighbourhoodInfo::UNKNOWN;
+  uint32_t self = this->GetNode()->GetId();
+
+  // distance vector of the supernodes of every level, each within its overlay radius
+  m_overlayRoutes.clear();
+  for (const auto& neighbour : m_neighbourhood) {
+    for (const auto& entry : neighbour.second.info.overlay) {
+      uint32_t distance = entry.distance + 1;
+      if (entry.supernodeId == self || entry.level == 0 || entry.level >= m_maxLevel
+          || distance > GetOverlayRadius(entry.level))
+        continue;
+      auto key = std::make_pair(entry.level, entry.supernodeId);
+      auto route = m_overlayRoutes.find(key);
+      if (route == m_overlayRoutes.end() || distance < route->second.distance)
+        m_overlayRoutes[key] = {distance, neighbour.second.face, entry.span, entry.parent};
+    }
+  }
+
+  for (uint32_t level = 1; level <= m_level && level < m_maxLevel; level++) {
+    auto begin = m_overlayRoutes.lower_bound(std::make_pair(level, 0u));
+    auto end = m_overlayRoutes.lower_bound(std::make_pair(level + 1, 0u));
+
+    uint32_t span = m_parents[level] == UNKNOWN;
+    for (auto peer = begin; peer != end; ++peer)
+      span += peer->second.parent == UNKNOWN;
+    m_overlaySpans[level] = span;
+
+    if (m_level > level)
+      continue; // already a supernode one level up
+
+    bool elected = span > 0;
+    for (auto peer = begin; peer != end && elected; ++peer) {
+      elected = peer->second.span != UNKNOWN
+                && (peer->second.span < span || (peer->second.span == span && peer->first.second < self));
+    }
+
+    if (elected) {
+      NS_LOG_INFO("Level-" << level + 1 << " supernode with " << span << " uncovered level-"
+                  << level << " domains");
+      m_level = level + 1;
+      m_parents[level] = self;
+      m_levelChanged(self, m_level);
+      continue;
+    }
+
+    // join the nearest level + 1 supernode, staying with the current one while in range
+    auto parent = end;
+    for (auto peer = begin; peer != end; ++peer) {
+      if (peer->second.parent != peer->first.second)
+        continue;
+      if (peer->first.second == m_parents[level]) {
+        parent = peer;
+        break;
+      }
+      if (parent == end || peer->second.distance < parent->second.distance)
+        parent = peer;
+    }
+
+    uint32_t parentId = parent == end ? UNKNOWN : parent->first.second;
+    if (parentId != m_parents[level]) {
+      NS_LOG_INFO("Level-" << level << " domain joins level-" << level + 1 << " supernode " << parentId);
+      m_parents[level] = parentId;
+    }
+  }
+}
+
+void
+Clusterconsumer::SendAggregates()
+{
+  if (m_supernode == 0)
+    return;
+
+  uint32_t self = this->GetNode()->GetId();
+  for (uint32_t level = 1; level <= m_level && level < m_maxLevel; level++) {
+    uint32_t parentId = m_parents[level];
+    auto route = m_overlayRoutes.find(std::make_pair(level, parentId));
+    if (parentId == self || route == m_overlayRoutes.end())
+      continue;
+
+    bloom_filter filter = DynamicCast<Supernode>(m_supernode)->GetLevelFilter(level);
+    SendAggregate(self, level, parentId, route->second.face, route->second.distance - 1, filter);
+  }
+}
+
+bool
+Clusterconsumer::RelayAggregate(uint32_t origin, uint32_t level, uint32_t supernodeId, uint32_t ttl,
+                                const bloom_filter& filter)
+{
+  auto route = m_overlayRoutes.find(std::make_pair(level, supernodeId));
+  if (route == m_overlayRoutes.end() || route->second.distance > ttl)
+    return false;
+
+  SendAggregate(origin, level, supernodeId, route->second.face, route->second.distance - 1, filter);
+  return true;
+}
+
+void
+Clusterconsumer::ReceiveAggregate(uint32_t origin, uint32_t level, const bloom_filter& filter)
+{
+  if (m_supernode == 0 || level >= m_level) {
+    NS_LOG_DEBUG("Level-" << level << " aggregate from " << origin << " ignored");
+    return;
+  }
+
+  DynamicCast<Supernode>(m_supernode)->SetChildFilter(level, origin, filter);
+}
+
+bool
+Clusterconsumer::RelayDistantFilter(uint32_t origin, uint32_t via, uint32_t supernodeId,
+                                    uint32_t hops, uint32_t ttl, const bloom_filter& filter)
+{
+  auto route = m_overlayRoutes.find(std::make_pair(1u, supernodeId));
+  if (route == m_overlayRoutes.end() || route->second.distance > ttl)
+    return false;
+
+  SendDistantFilter(origin, via, supernodeId, route->second.face, hops, route->second.distance - 1,
+                    filter);
+  return true;
+}
+
+void
+Clusterconsumer::ReceiveDistantFilter(uint32_t origin, uint32_t via, uint32_t face, uint32_t hops,
+                                      const bloom_filter& filter)
+{
+  if (origin == this->GetNode()->GetId())
+    return;
+
+  // a filter from fewer hops is kept until it is MissedRounds periods old
+  Time expiry = Seconds(m_missedRounds / m_frequency);
+  auto entry = m_distantFilters.find(origin);
+  if (entry != m_distantFilters.end() && entry->second.hops < hops
+      && Simulator::Now() - entry->second.received <= expiry)
+    return;
+
+  m_distantFilters[origin] = {face, via, hops, filter, Simulator::Now()};
+}
+
+const std::map<uint32_t, Clusterconsumer::DistantFilter>&
+Clusterconsumer::GetDistantFilters() const
+{
+  return m_distantFilters;
+}
+
+void
+Clusterconsumer::SendDistantFilters()
+{
+  Time expiry = Seconds(m_missedRounds / m_frequency);
+  for (auto it = m_distantFilters.begin(); it != m_distantFilters.end();) {
+    if (Simulator::Now() - it->second.received > expiry)
+      it = m_distantFilters.erase(it);
+    else
+      ++it;
+  }
+
+  if (m_supernode == 0 || !IsSupernode())
+    return;
+
+  uint32_t self = this->GetNode()->GetId();
+  const bloom_filter& domainFilter = DynamicCast<Supernode>(m_supernode)->GetDomainFilter();
+  auto begin = m_overlayRoutes.lower_bound(std::make_pair(1u, 0u));
+  auto end = m_overlayRoutes.lower_bound(std::make_pair(2u, 0u));
+  for (auto peer = begin; peer != end; ++peer) {
+    uint32_t supernodeId = peer->first.second;
+    const OverlayRoute& route = peer->second;
+    SendDistantFilter(self, self, supernodeId, route.face, 1, route.distance - 1, domainFilter);
+
+    // one overlay hop further, not back where they came from
+    for (const auto& entry : m_distantFilters) {
+      if (entry.second.hops >= m_filterReach || entry.first == supernodeId
+          || entry.second.via == supernodeId)
+        continue;
+
+      // a table that cannot be halved any further is not forwarded at full size either
+      MutableBloomFilter folded(entry.second.filter);
+      if (!folded.Fold()) {
+        NS_LOG_DEBUG("Cannot fold the filter of " << entry.first << ", not forwarding it");
+        continue;
+      }
+      SendDistantFilter(entry.first, self, supernodeId, route.face, entry.second.hops + 1,
+                        route.distance - 1, folded);
+    }
+  }
+}
+
+void
+Clusterconsumer::SendDistantFilter(uint32_t origin, uint32_t via, uint32_t supernodeId,
+                                   uint32_t face, uint32_t hops, uint32_t ttl,
+                                   const bloom_filter& filter)
+{
+  uint32_t seq = m_seq++;
+
+  // /localhop/Cluster/DST/<origin>/<via>/<supernode>/<hops>/<ttl>/<seq>, not answered
+  shared_ptr<Name> nameWithSequence = make_shared<Name>("ndn:/localhop/Cluster/DST");
+  nameWithSequence->appendNumber(origin);
+  nameWithSequence->appendNumber(via);
+  nameWithSequence->appendNumber(supernodeId);
+  nameWithSequence->appendNumber(hops);
+  nameWithSequence->appendNumber(ttl);
+  nameWithSequence->appendSequenceNumber(seq);
+
+  shared_ptr<Interest> interest = make_shared<Interest>();
+  interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
+  interest->setName(*nameWithSequence);
+  time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
+  interest->setInterestLifetime(interestLifeTime);
+  interest->setBfComponents(filter.size(), filter.table(), filter.element_count(), filter.salt_count());
+
+  shared_ptr<ndn::lp::NextHopFaceIdTag> tag = make_shared<ndn::lp::NextHopFaceIdTag>(face);
+  interest->setTag(tag);
+
+  NS_LOG_INFO("Sending the filter of " << origin << " to Node " << supernodeId << ", " << hops
+              << " overlay hops");
+  if (via == this->GetNode()->GetId())
+    m_distantFilterSent(via, hops, filter.size() / 8);
+
+  m_transmittedInterests(interest, this, m_face);
+  m_appLink->onReceiveInterest(*interest);
+}
+
+void
+Clusterconsumer::SendAggregate(uint32_t origin, uint32_t level, uint32_t supernodeId, uint32_t face,
+                               uint32_t ttl, const bloom_filter& filter)
+{
+  uint32_t seq = m_seq++;
+
+  shared_ptr<Name> nameWithSequence = make_shared<Name>("ndn:/localhop/Cluster/AGG");
+  nameWithSequence->appendNumber(origin);
+  nameWithSequence->appendNumber(level);
+  nameWithSequence->appendNumber(supernodeId);
+  nameWithSequence->appendNumber(ttl);
+  nameWithSequence->appendSequenceNumber(seq);
+
+  shared_ptr<Interest> interest = make_shared<Interest>();
+  interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
+  interest->setName(*nameWithSequence);
+  time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
+  interest->setInterestLifetime(interestLifeTime);
+  interest->setBfComponents(filter.size(), filter.table(), filter.element_count(), filter.salt_count());
+
+  shared_ptr<ndn::lp::NextHopFaceIdTag> tag = make_shared<ndn::lp::NextHopFaceIdTag>(face);
+  interest->setTag(tag);
+
+  NS_LOG_INFO("Sending level-" << level << " aggregate of " << origin << " to Node " << supernodeId);
+
+  WillSendOutInterest(seq);
+
+  m_transmittedInterests(interest, this, m_face);
+  m_appLink->onReceiveInterest(*interest);
+}
+
+void Clusterconsumer::SendSupernode(uint32_t supernodeId, uint32_t face, uint32_t ttl, uint32_t origin,
+                                    uint32_t role, uint32_t other)
+{
+  uint32_t seq = m_seq++;
+
+  // the supernode and the remaining hops let nodes on a k-hop path relay the SCI, role and
+  // the other supernode of the member are for DoubleDomination
+  shared_ptr<Name> nameWithSequence = make_shared<Name>("ndn:/localhop/Cluster/SCI");
+  nameWithSequence->appendNumber(origin);
+  nameWithSequence->appendNumber(supernodeId);
+  nameWithSequence->appendNumber(ttl);
+  nameWithSequence->appendNumber(role);
+  nameWithSequence->appendNumber(other);
+  nameWithSequence->appendSequenceNumber(seq);
+
+  // an unanswered SCI to the primary triggers the failover
+  if (m_doubleDomination)
+    m_sciSupernodes[seq] = supernodeId;
+
+  shared_ptr<Interest> interest = make_shared<Interest>();
+  interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
+  interest->setName(*nameWithSequence);
+  time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
+  interest->setInterestLifetime(interestLifeTime);
+  interest->setSCI();
+
+  shared_ptr<ndn::lp::NextHopFaceIdTag> tag = make_shared<ndn::lp::NextHopFaceIdTag>(face);
+  interest->setTag(tag);
+
+  NS_LOG_INFO("Sending " << interest->getName() << " to Node " << supernodeId);
+  
+  WillSendOutInterest(seq);
+
+  m_transmittedInterests(interest, this, m_face);
+  m_appLink->onReceiveInterest(*interest);
+  return;
+}
+
+} // namespace ndn
+} // namespace ns3
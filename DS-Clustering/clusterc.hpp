@@ -1,105 +1,788 @@
-/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
-/**
- * Copyright (c) 2011-2015  Regents of the University of California.
- *
- * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
- * contributors.
- *
- * ndnSIM is free software: you can redistribute it and/or modify it under the terms
- * of the GNU General Public License as published by the Free Software Foundation,
- * either version 3 of the License, or (at your option) any later version.
- *
- * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
- * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
- * PURPOSE.  See the GNU General Public License for more details.
- *
- * You should have received a copy of the GNU General Public License along with
- * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
- **/
-
-#ifndef CLUSTERCONSUMER
-#define CLUSTERCONSUMER
-
-#include "ns3/ndnSIM/model/ndn-common.hpp"
-
-#include "ndn-consumer.hpp"
-#include "ns3/ndnSIM/ndn-cxx/neighbour.hpp"
-#include "ndn-cxx/tag.hpp"
-
-#include <array>
-
-namespace ns3 {
-namespace ndn {
-
-/**
- * @ingroup ndn-apps
- * @brief Ndn application for sending out Interest packets at a "constant" rate (Poisson process)
- */
-class Clusterconsumer : public Consumer {
-public:
-  static TypeId
-  GetTypeId();
-
-  /**
-   * \brief Default constructor
-   * Sets up randomizer function and packet sequence number
-   */
-  Clusterconsumer();
-  virtual ~Clusterconsumer();
-
-protected:
-  // from App
-  virtual void
-  StartApplication();
-
-  /**
-   * \brief Constructs the Interest packet and sends it using a callback to the underlying NDN
-   * protocol
-   */
-  virtual void
-  ScheduleNextPacket();
-
-  /**
-   * @brief Actually send packet
-   */
-  void
-  SendPacket();
-
-  /**
-   * @brief Set type of frequency randomization
-   * @param value Either 'none', 'uniform', or 'exponential'
-   */
-  void
-  SetRandomize(const std::string& value);
-
-  /**
-   * @brief Get type of frequency randomization
-   * @returns either 'none', 'uniform', or 'exponential'
-   */
-  std::string
-  GetRandomize() const;
-
-  // From App
-  virtual void
-  OnData(shared_ptr<const Data> contentObject);
-
-  void BestNeighbour();
-
-  void SendSupernode();
-
-protected:
-  double m_frequency; // Frequency of interest packets (in hertz)
-  bool m_firstTime;
-  Ptr<RandomVariableStream> m_random;
-  std::string m_randomType;
-  std::vector<NEntry> m_neighbours;
-  uint32_t best_nId;
-  uint32_t best_face;
-  uint32_t best_nN;
-  uint32_t m_answers;
-};
-
-} // namespace ndn
-} // namespace ns3
-
-#endif
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef CLUSTERCONSUMER
+#define CLUSTERCONSUMER
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include "ndn-consumer.hpp"
+#include "ns3/ndnSIM/ndn-cxx/neighbour.hpp"
+#include "ns3/ndnSIM/ndn-cxx/bloom_filter.hpp"
+#include "ndn-cxx/tag.hpp"
+
+#include "ns3/traced-callback.h"
+
+#include "neighbourhood.hpp"
+
+#include <array>
+#include <map>
+#include <set>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn-apps
+ * @brief Ndn application for sending out Interest packets at a "constant" rate (Poisson process)
+ */
+class Clusterconsumer : public Consumer {
+public:
+  static TypeId
+  GetTypeId();
+
+  /**
+   * \brief Default constructor
+   * Sets up randomizer function and packet sequence number
+   */
+  Clusterconsumer();
+  virtual ~Clusterconsumer();
+
+  typedef void (*RoleChangedCallback)(uint32_t nodeId, bool isSupernode);
+  typedef void (*SupernodeChangedCallback)(uint32_t nodeId, uint32_t supernodeId, uint32_t face);
+  typedef void (*LevelChangedCallback)(uint32_t nodeId, uint32_t level);
+  typedef void (*FailoverCallback)(uint32_t nodeId, uint32_t failedId, uint32_t backupId);
+  typedef void (*RepairCallback)(uint32_t nodeId, uint32_t hops);
+  typedef void (*HandoverCallback)(uint32_t nodeId, uint32_t successorId, double load);
+  typedef void (*DistantFilterSentCallback)(uint32_t nodeId, uint32_t hops, uint32_t bytes);
+
+  /// Role of an SCI, with DoubleDomination
+  enum SciRole {
+    SCI_PRIMARY = 0,
+    SCI_BACKUP = 1,
+    SCI_FAILOVER = 2 ///< the member's primary failed, the receiver takes over its domain
+  };
+
+  /// First content byte of an SCI reply, a one-byte content
+  enum SciStatus {
+    SCI_ACCEPTED = 0,
+    SCI_REFUSED = 1 ///< the domain is full, see MaxDomainSize
+  };
+
+  /**
+   * @brief Find the Clusterconsumer installed on a node
+   * @returns 0 if the node has none
+   */
+  static Ptr<Clusterconsumer>
+  GetClusterconsumer(Ptr<Node> node);
+
+  /**
+   * @brief Turn this node into a supernode, reachable through face
+   *
+   * Installs the supernode application on first call, later calls only log.
+   */
+  void
+  BecomeSupernode(uint32_t face);
+
+  /**
+   * @brief Whether this node acts as a supernode
+   *
+   * False again after the node handed its role over, see LoadThreshold; its Node keeps the
+   * supernode mark.
+   */
+  bool
+  IsSupernode() const;
+
+  /**
+   * @brief Whether this node handed its supernode role over less than RotationCooldown ago
+   *
+   * Such a node refuses SCIs and does not run for election.
+   */
+  bool
+  InRotationCooldown() const;
+
+  /**
+   * @brief A member sent this supernode an SCI, counted for the load
+   */
+  void
+  CountMember(uint32_t memberId);
+
+  /**
+   * @brief Admission control for a member joining this supernode's domain
+   *
+   * Members known from an earlier SCI are always admitted; a new member is refused once the
+   * domain holds MaxDomainSize members. A member leaves the domain after MissedRounds periods
+   * without an SCI.
+   *
+   * @param force admit even a full domain, for a failover
+   * @returns false if the member is refused
+   */
+  bool
+  AdmitMember(uint32_t memberId, bool force = false);
+
+  /**
+   * @brief Members that sent an SCI within the last MissedRounds periods
+   */
+  uint32_t
+  GetDomainSize() const;
+
+  /**
+   * @brief Become a supernode in place of the overloaded neighbour `from`, merging its filter
+   * @param face face recorded as supernode face
+   */
+  void
+  AcceptHandover(uint32_t from, uint32_t face, const bloom_filter& filter);
+
+  /**
+   * @brief Stop all periodic traffic of this node (CII and, for supernodes, IIM)
+   *
+   * Used once the clustering has converged; roles and filters are kept as they are.
+   */
+  void
+  Quiesce();
+
+  /**
+   * @brief Whether Quiesce would leave no work undone: the node advertises no services (its
+   *        RES pushes size the service shards) and its supernode application has no upkeep
+   */
+  bool
+  CanQuiesce() const;
+
+  uint32_t
+  GetSupernodeId() const;
+
+  uint32_t
+  GetSupernodeFace() const;
+
+  /**
+   * @brief Domain filter of this node's supernode application
+   * @returns 0 if this node is not a supernode
+   */
+  const bloom_filter*
+  GetDomainFilter() const;
+
+  /// Domain filter of an adjacent supernode, as heard in its IIM, or service filter of a member
+  struct SupernodeFilter
+  {
+    uint32_t face;
+    bloom_filter filter;                     // empty for members
+    std::map<uint32_t, bloom_filter> shards; // IIM segments or RES, by shard
+  };
+
+  /**
+   * @brief Keep the domain filter an adjacent supernode sent in its IIM, for service routing
+   */
+  void
+  ReceiveSupernodeFilter(uint32_t supernodeId, uint32_t face, const bloom_filter& filter);
+
+  /**
+   * @brief Domain filters of the adjacent supernodes, by supernode id
+   */
+  const std::map<uint32_t, SupernodeFilter>&
+  GetSupernodeFilters() const;
+
+  /**
+   * @brief Keep a shard of an adjacent supernode's domain filter from its IIM segment; the
+   *        capacity of a shard of this node's supernode is the one to build RES filters at
+   */
+  void
+  ReceiveSupernodeShard(uint32_t supernodeId, uint32_t face, uint32_t shard, uint64_t capacity,
+                        const bloom_filter& filter);
+
+  /**
+   * @brief A shard of this supernode's sharded domain filter, 0 if empty or not a supernode
+   */
+  const bloom_filter*
+  GetDomainShard(uint32_t shard) const;
+
+  /**
+   * @brief Faces of the neighbours in this supernode's domain
+   */
+  std::vector<uint32_t>
+  GetMemberFaces() const;
+
+  /**
+   * @brief Hops to a supernode: its route in k-hop mode, else 1 for a neighbour
+   * @returns NeighbourhoodInfo::UNKNOWN if it is neither
+   */
+  uint32_t
+  GetSupernodeDistance(uint32_t supernodeId) const;
+
+  /**
+   * @brief Ask an adjacent supernode, reachable through face, to rebuild its noisy domain filter
+   */
+  void
+  RequestFilterRebuild(uint32_t supernodeId, uint32_t face);
+
+  /**
+   * @brief An adjacent node found this supernode's domain filter noisy
+   */
+  void
+  RebuildFilter(uint32_t origin);
+
+  /**
+   * @brief Advertise a service provided on this node, with the quantised Cpu and Ram
+   *        (ResourceClass), in the sharded domain filter of its supernode
+   *
+   * The service filters, one per shard, are pushed to the supernode every round, so they
+   * outlive a rebuild and follow the capacity the supernode announces for the shard.
+   */
+  void
+  AdvertiseService(const Name& service);
+
+  /**
+   * @brief Whether this supernode's domain has a provider of service with at least the given
+   *        Cpu and Ram classes, as far as the domain filter tells
+   */
+  bool
+  HasService(const Name& service, uint32_t minCpuClass, uint32_t minRamClass) const;
+
+  /**
+   * @brief Forward a member's service filter one hop towards its supernode
+   * @returns false if there is no route within ttl hops
+   */
+  bool
+  RelayServiceFilter(uint32_t origin, uint32_t supernodeId, uint32_t ttl, uint32_t shard,
+                     const bloom_filter& filter);
+
+  /**
+   * @brief Merge a member's service filter into a shard of the domain filter, and keep it
+   *        apart if the member is a neighbour, arrived on face, for provider selection
+   */
+  void
+  ReceiveServiceFilter(uint32_t origin, uint32_t face, uint32_t shard, const bloom_filter& filter);
+
+  /**
+   * @brief Service filters of the neighbouring members, by member id
+   */
+  const std::map<uint32_t, SupernodeFilter>&
+  GetMemberServiceFilters() const;
+
+  /**
+   * @brief Start in an already converged state instead of running the CII/SCI election
+   *
+   * Must be called before the application starts.
+   * @param domainFilter filter loaded into the supernode application, ignored for members
+   */
+  void
+  WarmStart(uint32_t supernodeId, uint32_t face, const bloom_filter* domainFilter);
+
+  /**
+   * @brief Forward an SCI from a member further away towards its supernode (k-hop mode)
+   *
+   * @param origin   member that sent the SCI
+   * @param ttl      hops this node may still be away from the supernode
+   * @returns false if the supernode is not within ttl hops of this node
+   */
+  bool
+  RelaySupernode(uint32_t origin, uint32_t supernodeId, uint32_t ttl);
+
+  /**
+   * @brief Re-pull the neighbourhood now instead of waiting for the next CII period
+   *
+   * Repairs are coalesced over RepairDelay. Neighbours that receive the repair CII repair
+   * with hops - 1, so with RepairHops = 2 the 2-hop neighbourhood of a change recomputes
+   * its roles; a repair spreads further only while it changes what nodes advertise.
+   *
+   * @param hops how far the repair is passed on, 0 to only refresh this node
+   */
+  void
+  Repair(uint32_t hops);
+
+  /**
+   * @brief A device of this node went up or down
+   *
+   * Bound to the link change callbacks of the node's devices; scenarios call it directly
+   * for devices that do not report carrier changes.
+   */
+  void
+  LinkChanged();
+
+  /**
+   * @brief Weighted capability of this node as a supernode, in thousandths, at least 1
+   *
+   * WeightDegree * neighbours + WeightCpu * Cpu + WeightRam * Ram + WeightLink * link
+   * capacity (Gbps, summed over the node's devices) - WeightLoad * Load. The weighted
+   * election ranks nodes by span * score; the degree election by score alone.
+   */
+  uint32_t
+  GetScore() const;
+
+  /**
+   * @brief Moving average of the change of the neighbour set between CII rounds, 0 to 1
+   */
+  double
+  GetChurn() const;
+
+  uint32_t
+  GetBackupId() const;
+
+  /**
+   * @brief A member of this supernode named backupId as its secondary, reachable through face
+   *
+   * This supernode then pushes warm copies of its domain filter to backupId via that member.
+   */
+  void
+  SetMemberBackup(uint32_t backupId, uint32_t face);
+
+  /**
+   * @brief Forward a warm filter copy to a neighbouring supernode
+   * @returns false if backupId is not a neighbour
+   */
+  bool
+  RelayBackupFilter(uint32_t origin, uint32_t backupId, const bloom_filter& filter);
+
+  void
+  ReceiveBackupFilter(uint32_t origin, const bloom_filter& filter);
+
+  /**
+   * @brief A member failed over from failedId to this supernode
+   */
+  void
+  TakeOver(uint32_t failedId);
+
+  /**
+   * @brief Highest level this node is a supernode at, 0 for members
+   */
+  uint32_t
+  GetLevel() const;
+
+  /**
+   * @brief Forward a level aggregate one hop towards the overlay supernode it is meant for
+   * @returns false if that supernode is not within ttl hops of this node
+   */
+  bool
+  RelayAggregate(uint32_t origin, uint32_t level, uint32_t supernodeId, uint32_t ttl,
+                 const bloom_filter& filter);
+
+  /**
+   * @brief A level-`level` supernode of this node's overlay domain reported its aggregate
+   */
+  void
+  ReceiveAggregate(uint32_t origin, uint32_t level, const bloom_filter& filter);
+
+  /**
+   * @brief Domain filter of a supernode beyond the adjacent domains
+   *
+   * Folded once (MutableBloomFilter::Fold) for every overlay hop it travelled beyond the
+   * first, so it is queried as is, with more false positives the farther its origin.
+   */
+  struct DistantFilter
+  {
+    uint32_t face; // towards the supernode that forwarded it
+    uint32_t via;  // that supernode
+    uint32_t hops; // overlay hops from its origin
+    bloom_filter filter;
+    Time received;
+  };
+
+  /**
+   * @brief Forward a distant filter one hop towards the overlay supernode it is meant for
+   * @returns false if that supernode is not within ttl hops of this node
+   */
+  bool
+  RelayDistantFilter(uint32_t origin, uint32_t via, uint32_t supernodeId, uint32_t hops,
+                     uint32_t ttl, const bloom_filter& filter);
+
+  /**
+   * @brief Keep the filter of origin that arrived on face, unless a fresh one from fewer
+   *        overlay hops is known; relays keep it too, so every node on the way can route
+   *        towards origin
+   */
+  void
+  ReceiveDistantFilter(uint32_t origin, uint32_t via, uint32_t face, uint32_t hops,
+                       const bloom_filter& filter);
+
+  /**
+   * @brief Distant filters by origin supernode id
+   */
+  const std::map<uint32_t, DistantFilter>&
+  GetDistantFilters() const;
+
+  /**
+   * @brief What this node advertises about itself in its CII replies
+   */
+  NeighbourhoodInfo
+  GetNeighbourhoodInfo() const;
+
+protected:
+  // from App
+  virtual void
+  StartApplication();
+
+  /**
+   * \brief Constructs the Interest packet and sends it using a callback to the underlying NDN
+   * protocol
+   */
+  virtual void
+  ScheduleNextPacket();
+
+  /**
+   * @brief Actually send packet
+   */
+  void
+  SendPacket();
+
+  /**
+   * @brief Set type of frequency randomization
+   * @param value Either 'none', 'uniform', or 'exponential'
+   */
+  void
+  SetRandomize(const std::string& value);
+
+  /**
+   * @brief Get type of frequency randomization
+   * @returns either 'none', 'uniform', or 'exponential'
+   */
+  std::string
+  GetRandomize() const;
+
+  // From App
+  virtual void
+  OnData(shared_ptr<const Data> contentObject);
+
+  void BestNeighbour();
+
+  /**
+   * @brief CII frequency, raised from Frequency towards MaxFrequency with the churn
+   */
+  double
+  GetFrequency() const;
+
+  /**
+   * @brief Whether to leave the current supernode for a candidate
+   *
+   * Scores are larger for better supernodes, HandoverMargin counts in units of them (1000 for
+   * the weighted election scores). A member switches to a candidate beating the current one
+   * by more than the margin, to any strictly better one with a margin of 0, and never with
+   * KeepSupernode.
+   */
+  bool
+  IsHandover(uint32_t currentScore, uint32_t candidateScore, uint32_t unit = 1) const;
+
+  /**
+   * @brief Whether the supernode refused this node less than MissedRounds rounds ago
+   */
+  bool
+  IsRefused(uint32_t supernodeId) const;
+
+  /**
+   * @brief Whether a supernode advertises a domain of MaxDomainSize members
+   */
+  bool
+  IsFull(const NeighbourhoodInfo& info) const;
+
+  /**
+   * @brief Load of this supernode over the last CII period, from MaxMembers and MaxMergeRate
+   *
+   * Replaces the Load attribute, and thereby lowers the score, once either is set.
+   */
+  void
+  UpdateLoad();
+
+  /**
+   * @brief Hand the supernode role and domainFilter to the best-scoring neighbour that is
+   *        not a supernode, with a /localhop/Cluster/SHO Interest
+   */
+  void
+  HandOver();
+
+  /**
+   * @brief The successor confirmed the handover: join it and stop acting as a supernode
+   */
+  void
+  Retire(uint32_t successorId, uint32_t face);
+
+  /**
+   * @brief Replies expected per CII round: the known neighbours, the devices before the first round
+   */
+  uint32_t
+  GetExpectedAnswers() const;
+
+  /**
+   * @brief Run the election on the replies of the current round, once per round
+   */
+  void
+  ElectRound();
+
+  /**
+   * @brief End the current CII round
+   *
+   * Elects if the round did not complete and drops neighbours that stayed silent for
+   * MissedRounds rounds, or through a whole repair round.
+   *
+   * @param timedOut the round ended after InterestLifetime rather than by the next CII
+   */
+  void
+  CloseRound(bool timedOut);
+
+  /**
+   * @brief Forget a neighbour that is gone, failing over or leaving its domain if it was a supernode
+   */
+  void
+  LoseNeighbour(uint32_t nodeId);
+
+  void
+  SendRepair();
+
+  /**
+   * @brief Start a new CII round
+   * @param repairHops how far receivers pass the repair on, 0 for periodic rounds
+   */
+  void
+  SendCii(uint32_t seq, bool repair, uint32_t repairHops);
+
+  /**
+   * @brief Greedy election on the 2-hop neighbourhood
+   *
+   * A node whose span (undominated nodes in its closed neighbourhood) is the largest among
+   * its neighbours, ties broken by id, becomes a supernode; undominated nodes join an
+   * adjacent supernode and otherwise wait for one to be elected.
+   *
+   * @param localFace face recorded as supernode face if this node is elected
+   */
+  void
+  ElectByCoverage(uint32_t localFace);
+
+  /**
+   * @brief Undominated nodes in N[v], from the neighbours' last CII replies
+   */
+  uint32_t
+  GetSpan() const;
+
+  /**
+   * @brief k-hop variant of ElectByCoverage, used when K > 1
+   *
+   * Supernodes within K hops are learnt from the neighbours' distance vectors and joined
+   * through the neighbour towards the nearest one. Nominations (span, id) spread K hops; a
+   * node with the best nomination in its K-hop neighbourhood becomes a supernode.
+   */
+  void
+  ElectKHop(uint32_t localFace);
+
+  /**
+   * @brief Hops within which two level-`level` supernodes are overlay neighbours
+   *
+   * 2 R + 1 for the radius R of a level-`level` domain, so that adjacent domains are always
+   * neighbours; R is K at level 1 and grows by the overlay radius of every level below.
+   */
+  uint32_t
+  GetOverlayRadius(uint32_t level) const;
+
+  /**
+   * @brief The coverage election run again on the supernode overlay, level by level
+   *
+   * Every level-l supernode (l < MaxLevel) learns the level-l supernodes within its overlay
+   * radius from a distance vector in the CII replies and either becomes a level l + 1
+   * supernode, if its span among them is the largest, or joins the nearest one.
+   */
+  void
+  ElectOverlay();
+
+  /**
+   * @brief Push this node's level aggregates to its overlay supernodes, once per CII period
+   */
+  void
+  SendAggregates();
+
+  void
+  SendAggregate(uint32_t origin, uint32_t level, uint32_t supernodeId, uint32_t face, uint32_t ttl,
+                const bloom_filter& filter);
+
+  /**
+   * @brief Send the domain filter to the level-1 overlay neighbours, with the distant filters
+   *        this supernode holds from fewer than FilterReach overlay hops, folded once more
+   */
+  void
+  SendDistantFilters();
+
+  void
+  SendDistantFilter(uint32_t origin, uint32_t via, uint32_t supernodeId, uint32_t face,
+                    uint32_t hops, uint32_t ttl, const bloom_filter& filter);
+
+  /**
+   * @brief Send an SCI towards supernodeId through face
+   * @param ttl hops beyond the next one, 0 if the supernode is a neighbour
+   */
+  void
+  SendSupernode(uint32_t supernodeId, uint32_t face, uint32_t ttl, uint32_t origin,
+                uint32_t role = SCI_PRIMARY, uint32_t other = NeighbourhoodInfo::UNKNOWN);
+
+  /**
+   * @brief Pick the secondary supernode among the neighbours other than the primary
+   */
+  void
+  SelectBackup();
+
+  /**
+   * @brief Switch to the secondary supernode after the primary stopped answering SCIs
+   */
+  void
+  Failover();
+
+  void
+  SendBackupFilters();
+
+  void
+  SendBackupFilter(uint32_t origin, uint32_t backupId, uint32_t face, const bloom_filter& filter);
+
+  /**
+   * @brief Push the service filter to the supernode, or merge it if this node is one
+   */
+  void
+  SendServiceFilter();
+
+  void
+  SendServiceFilter(uint32_t origin, uint32_t supernodeId, uint32_t face, uint32_t ttl,
+                    uint32_t shard, const bloom_filter& filter);
+
+  // From Consumer
+  virtual void
+  OnTimeout(uint32_t sequenceNumber);
+
+  void
+  SetSupernodeFace(uint32_t supernodeId, uint32_t face);
+
+protected:
+  double m_frequency; // Frequency of interest packets (in hertz)
+  bool m_firstTime;
+  Ptr<RandomVariableStream> m_random;
+  std::string m_randomType;
+  std::vector<NEntry> m_neighbours;
+  uint32_t best_nId;
+  uint32_t best_face;
+  uint32_t best_nN;
+  uint32_t m_round;                  // CII rounds started so far
+  std::set<uint32_t> m_roundAnswers; // neighbours that answered the current round
+  bool m_roundElected;
+  bool m_repairRound; // current round was started by Repair
+  EventId m_roundEvent;
+  uint32_t m_localFace; // reported by CII replies, recorded as supernode face when elected
+  uint32_t m_missedRounds;
+  uint32_t m_repairHops;
+  Time m_repairDelay;
+  uint32_t m_pendingRepair; // hops of the scheduled repair
+  EventId m_repairEvent;
+  NeighbourhoodInfo m_advertised; // as of the last election
+  bool m_roundClosed;
+
+  double m_maxFrequency;
+  double m_churnWeight;
+  double m_churn;                    // EWMA of the Jaccard distance of consecutive neighbour sets
+  std::set<uint32_t> m_lastAnswers; // neighbours that answered the last periodic round
+  uint32_t m_handoverMargin;
+  bool m_keepSupernode;
+
+  double m_cpu;          // relative CPU capacity
+  double m_ram;          // GB
+  double m_load;         // 0 idle to 1 saturated
+  double m_linkCapacity; // Gbps, summed over the devices
+  double m_weightDegree;
+  double m_weightCpu;
+  double m_weightRam;
+  double m_weightLink;
+  double m_weightLoad;
+
+  double m_loadThreshold;
+  uint32_t m_maxMembers;
+  double m_maxMergeRate;
+  Time m_rotationCooldown;
+  bool m_retired;
+  Time m_lastRotation;
+  std::set<uint32_t> m_members; // that sent an SCI this period
+  uint64_t m_lastMerges;
+  Time m_lastLoadUpdate;
+  std::map<uint32_t, uint32_t> m_handovers; // outstanding SHO: sequence number to successor
+
+  uint32_t m_maxDomainSize;
+  uint32_t m_minDomainSize;
+  std::map<uint32_t, Time> m_domainMembers; // admitted member to its last SCI
+  std::map<uint32_t, uint32_t> m_refused;   // supernode to the last round it is avoided
+
+  /// @brief Fired when this supernode hands its role over (node id, successor id, load)
+  TracedCallback<uint32_t, uint32_t, double> m_handedOver;
+
+  /// @brief Fired when this node starts a repair round (node id, hops)
+  TracedCallback<uint32_t, uint32_t> m_repaired;
+
+  std::string m_election; // "coverage", "weighted" or "degree"
+  uint32_t m_span;        // as last advertised, NeighbourhoodInfo::UNKNOWN before the first round
+  uint32_t m_k;           // maximum hops between a member and its supernode
+
+  struct SupernodeRoute
+  {
+    uint32_t distance;
+    uint32_t face; // towards the next hop
+  };
+  std::map<uint32_t, SupernodeRoute> m_supernodeRoutes;   // supernodes within K hops
+  std::vector<NeighbourhoodInfo::Candidate> m_candidates; // best nomination within 0..K-1 hops
+
+  uint32_t m_maxLevel;
+  uint32_t m_filterReach; // overlay hops a domain filter travels
+  uint32_t m_level;                     // highest level this node is a supernode at
+  std::vector<uint32_t> m_parents;      // [l]: level l + 1 supernode of this level-l supernode
+  std::vector<uint32_t> m_overlaySpans; // [l]: span in the level l + 1 election
+
+  struct OverlayRoute
+  {
+    uint32_t distance;
+    uint32_t face;
+    uint32_t span;
+    uint32_t parent;
+  };
+  std::map<std::pair<uint32_t, uint32_t>, OverlayRoute> m_overlayRoutes; // by (level, supernode id)
+
+  /// @brief Fired when this node is elected at a higher level of the overlay
+  TracedCallback<uint32_t, uint32_t> m_levelChanged;
+
+  /// @brief Fired for every distant filter this supernode sends (node id, hops, table bytes)
+  TracedCallback<uint32_t, uint32_t, uint32_t> m_distantFilterSent;
+
+  bool m_doubleDomination;
+  uint32_t m_backupId; // secondary supernode
+  uint32_t m_backupFace;
+  std::map<uint32_t, uint32_t> m_sciSupernodes; // outstanding SCIs: sequence number to supernode
+  std::map<uint32_t, uint32_t> m_memberBackups; // supernode only: backup id to face of a member
+
+  /// @brief Fired when this node switches to its secondary supernode
+  TracedCallback<uint32_t, uint32_t, uint32_t> m_failover;
+
+  Ptr<App> m_supernode; // supernode application, once this node has been elected
+  uint32_t m_supernodeId;
+  uint32_t m_supernodeFace;
+  bool m_quiesced;
+  bool m_warmStart;
+
+  struct Neighbour
+  {
+    uint32_t face;
+    uint32_t round; // last round it answered
+    NeighbourhoodInfo info;
+  };
+
+  std::map<uint32_t, Neighbour> m_neighbourhood; // by node id, with each neighbour's 1-hop set
+  std::map<uint32_t, SupernodeFilter> m_supernodeFilters; // adjacent supernodes, from IIM
+  std::vector<Name> m_services;                  // provided on this node
+  std::map<uint32_t, uint64_t> m_shardCapacities; // announced by the supernode, by shard
+  std::map<uint32_t, SupernodeFilter> m_memberServiceFilters; // neighbours, from RES
+  std::map<uint32_t, DistantFilter> m_distantFilters; // beyond the adjacent domains, from DST
+  bool m_neighbourhoodChanged;
+
+  /// @brief Fired when this node becomes a supernode (node id, is supernode)
+  TracedCallback<uint32_t, bool> m_roleChanged;
+
+  /// @brief Fired when this node joins a domain (node id, supernode id, face)
+  TracedCallback<uint32_t, uint32_t, uint32_t> m_supernodeChanged;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif
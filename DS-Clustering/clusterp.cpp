@@ -1,166 +1,321 @@
-/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
-/**
- * Copyright (c) 2011-2015  Regents of the University of California.
- *
- * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
- * contributors.
- *
- * ndnSIM is free software: you can redistribute it and/or modify it under the terms
- * of the GNU General Public License as published by the Free Software Foundation,
- * either version 3 of the License, or (at your option) any later version.
- *
- * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
- * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
- * PURPOSE.  See the GNU General Public License for more details.
- *
- * You should have received a copy of the GNU General Public License along with
- * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
- **/
-
-#include "clusterp.hpp"
-#include "ns3/log.h"
-#include "ns3/string.h"
-#include "ns3/uinteger.h"
-#include "ns3/packet.h"
-#include "ns3/simulator.h"
-
-#include "model/ndn-l3-protocol.hpp"
-#include "helper/ndn-fib-helper.hpp"
-
-#include <memory>
-
-#include "supernode-ds.hpp"
-
-NS_LOG_COMPONENT_DEFINE("Clusterproducer");
-
-namespace ns3 {
-namespace ndn {
-
-NS_OBJECT_ENSURE_REGISTERED(Clusterproducer);
-
-TypeId
-Clusterproducer::GetTypeId(void)
-{
-  static TypeId tid =
-    TypeId("ns3::ndn::Clusterproducer")
-      .SetGroupName("Ndn")
-      .SetParent<App>()
-      .AddConstructor<Clusterproducer>()
-      .AddAttribute("Prefix", "Prefix, for which Clusterproducer has the data", StringValue("/"),
-                    MakeNameAccessor(&Clusterproducer::m_prefix), MakeNameChecker())
-
-      .AddAttribute(
-         "Postfix",
-         "Postfix that is added to the output data (e.g., for adding Clusterproducer-uniqueness)",
-         StringValue("/"), MakeNameAccessor(&Clusterproducer::m_postfix), MakeNameChecker())
-
-
-      .AddAttribute("PayloadSize", "Virtual payload size for Content packets", UintegerValue(1024),
-                    MakeUintegerAccessor(&Clusterproducer::m_virtualPayloadSize),
-                    MakeUintegerChecker<uint32_t>())
-
-      .AddAttribute("Freshness", "Freshness of data packets, if 0, then unlimited freshness",
-                    TimeValue(Seconds(0)), MakeTimeAccessor(&Clusterproducer::m_freshness),
-                    MakeTimeChecker())
-
-      .AddAttribute(
-         "Signature",
-         "Fake signature, 0 valid signature (default), other values application-specific",
-         UintegerValue(0), MakeUintegerAccessor(&Clusterproducer::m_signature),
-         MakeUintegerChecker<uint32_t>())
-
-      .AddAttribute("KeyLocator",
-                    "Name to be used for key locator.  If root, then key locator is not used",
-                    NameValue(), MakeNameAccessor(&Clusterproducer::m_keyLocator), MakeNameChecker());
-  return tid;
-}
-
-Clusterproducer::Clusterproducer()
-{
-  //NS_LOG_FUNCTION_NOARGS();
-}
-
-// inherited from Application base class.
-void
-Clusterproducer::StartApplication()
-{
-  NS_LOG_FUNCTION_NOARGS();
-  App::StartApplication();
-
-  FibHelper::AddRoute(GetNode(), m_prefix, m_face, 0);
-}
-
-void
-Clusterproducer::StopApplication()
-{
-  NS_LOG_FUNCTION_NOARGS();
-
-  App::StopApplication();
-}
-
-void
-Clusterproducer::OnInterest(shared_ptr<const Interest> interest)
-{
-  App::OnInterest(interest); // tracing inside
-  
-  Name dataName(interest->getName());
-  // dataName.append(m_postfix);
-  // dataName.appendVersion();
-
-  if (!m_active)
-    return;
-
-  auto data = make_shared<Data>();
-  data->setName(dataName);
-  data->setFreshnessPeriod(::ndn::time::milliseconds(m_freshness.GetMilliSeconds()));
-
-  data->setContent(make_shared< ::ndn::Buffer>(m_virtualPayloadSize));
-
-  Signature signature;
-  SignatureInfo signatureInfo(static_cast< ::ndn::tlv::SignatureTypeValue>(255));
-
-  if (m_keyLocator.size() > 0) {
-    signatureInfo.setKeyLocator(m_keyLocator);
-  }
-
-  signature.setInfo(signatureInfo);
-  signature.setValue(::ndn::makeNonNegativeIntegerBlock(::ndn::tlv::SignatureValue, m_signature));
-  data->setSignature(signature);
-  
-
-  NS_LOG_INFO(interest->getName() << " received");
-  data->setNodeId(this->GetNode()->GetId());
-  if(interest->isCII())
-  {
-    data->setNeighbours(this->GetNode()->GetNDevices());
-  } 
-  else if (interest->isSCI())
-  {
-    data->setSCI();
-    uint32_t nApp = this->GetNode()->GetNApplications();
-    bool isSupernode = false;
-    for (uint32_t i = 0; i<nApp; i++) {
-      if (this->GetNode()->IsSupernode()) {
-        isSupernode = true;
-      }
-    }
-    if (isSupernode) {
-      NS_LOG_INFO("Already a Supernode");
-    } else {
-      NS_LOG_INFO("Transforming into Supernode");    
-      this->GetNode()->AddApplication(new Supernode);
-      this->GetNode()->SetAsSupernode();
-      this->GetNode()->SetSupernodeFace(interest->getSCIFace());
-    }
-  } else { return; }
-
-
-  // to create real wire encoding
-  data->wireEncode();
-
-  m_transmittedDatas(data, this, m_face);
-  m_appLink->onReceiveData(*data);
-}
-
-} // namespace ndn
-} // namespace ns3
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "clusterp.hpp"
+#include "ns3/log.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+
+#include "model/ndn-l3-protocol.hpp"
+#include "helper/ndn-fib-helper.hpp"
+
+#include <memory>
+
+#include "clusterc.hpp"
+
+NS_LOG_COMPONENT_DEFINE("Clusterproducer");
+
+namespace ns3 {
+namespace ndn {
+
+NS_OBJECT_ENSURE_REGISTERED(Clusterproducer);
+
+TypeId
+Clusterproducer::GetTypeId(void)
+{
+  static TypeId tid =
+    TypeId("ns3::ndn::Clusterproducer")
+      .SetGroupName("Ndn")
+      .SetParent<App>()
+      .AddConstructor<Clusterproducer>()
+      .AddAttribute("Prefix", "Prefix, for which Clusterproducer has the data", StringValue("/"),
+                    MakeNameAccessor(&Clusterproducer::m_prefix), MakeNameChecker())
+
+      .AddAttribute(
+         "Postfix",
+         "Postfix that is added to the output data (e.g., for adding Clusterproducer-uniqueness)",
+         StringValue("/"), MakeNameAccessor(&Clusterproducer::m_postfix), MakeNameChecker())
+
+
+      .AddAttribute("PayloadSize", "Virtual payload size for Content packets", UintegerValue(1024),
+                    MakeUintegerAccessor(&Clusterproducer::m_virtualPayloadSize),
+                    MakeUintegerChecker<uint32_t>())
+
+      .AddAttribute("Freshness", "Freshness of data packets, if 0, then unlimited freshness",
+                    TimeValue(Seconds(0)), MakeTimeAccessor(&Clusterproducer::m_freshness),
+                    MakeTimeChecker())
+
+      .AddAttribute(
+         "Signature",
+         "Fake signature, 0 valid signature (default), other values application-specific",
+         UintegerValue(0), MakeUintegerAccessor(&Clusterproducer::m_signature),
+         MakeUintegerChecker<uint32_t>())
+
+      .AddAttribute("KeyLocator",
+                    "Name to be used for key locator.  If root, then key locator is not used",
+                    NameValue(), MakeNameAccessor(&Clusterproducer::m_keyLocator), MakeNameChecker());
+  return tid;
+}
+
+Clusterproducer::Clusterproducer()
+{
+  //NS_LOG_FUNCTION_NOARGS();
+}
+
+// inherited from Application base class.
+void
+Clusterproducer::StartApplication()
+{
+  NS_LOG_FUNCTION_NOARGS();
+  App::StartApplication();
+
+  FibHelper::AddRoute(GetNode(), m_prefix, m_face, 0);
+}
+
+void
+Clusterproducer::StopApplication()
+{
+  NS_LOG_FUNCTION_NOARGS();
+
+  App::StopApplication();
+}
+
+void
+Clusterproducer::OnInterest(shared_ptr<const Interest> interest)
+{
+  App::OnInterest(interest); // tracing inside
+  
+  Name dataName(interest->getName());
+  // dataName.append(m_postfix);
+  // dataName.appendVersion();
+
+  if (!m_active)
+    return;
+
+  auto data = make_shared<Data>();
+  data->setName(dataName);
+  data->setFreshnessPeriod(::ndn::time::milliseconds(m_freshness.GetMilliSeconds()));
+
+  data->setContent(make_shared< ::ndn::Buffer>(m_virtualPayloadSize));
+
+  Signature signature;
+  SignatureInfo signatureInfo(static_cast< ::ndn::tlv::SignatureTypeValue>(255));
+
+  if (m_keyLocator.size() > 0) {
+    signatureInfo.setKeyLocator(m_keyLocator);
+  }
+
+  signature.setInfo(signatureInfo);
+  signature.setValue(::ndn::makeNonNegativeIntegerBlock(::ndn::tlv::SignatureValue, m_signature));
+  data->setSignature(signature);
+  
+
+  NS_LOG_INFO(interest->getName() << " received");
+  data->setNodeId(this->GetNode()->GetId());
+  if(interest->isCII())
+  {
+    // distinct neighbours once known, parallel links would inflate the face count
+    uint32_t neighbours = this->GetNode()->GetNDevices();
+
+    Ptr<Clusterconsumer> consumer = Clusterconsumer::GetClusterconsumer(this->GetNode());
+    if (consumer != 0) {
+      NeighbourhoodInfo info = consumer->GetNeighbourhoodInfo();
+      if (!info.neighbours.empty())
+        neighbours = info.neighbours.size();
+      data->setContent(info.Encode());
+
+      // /<prefix>/CII/<origin>/<round>/<repair hops>: pass a repair on
+      const Name& name = interest->getName();
+      if (name.size() >= 4 && name.get(-4) == name::Component("CII")
+          && name.get(-3).toNumber() != this->GetNode()->GetId() && name.get(-1).toNumber() > 0)
+        consumer->Repair(name.get(-1).toNumber() - 1);
+    }
+    data->setNeighbours(neighbours);
+  } 
+  else if (interest->isSCI())
+  {
+    data->setSCI();
+    Ptr<Clusterconsumer> consumer = Clusterconsumer::GetClusterconsumer(this->GetNode());
+
+    // /localhop/Cluster/SCI/<origin>/<supernode>/<ttl>/<role>/<other>/<seq>
+    const Name& name = interest->getName();
+    uint32_t supernodeId = this->GetNode()->GetId();
+    uint32_t ttl = 0;
+    if (name.size() > 5) {
+      supernodeId = name.at(4).toNumber();
+      ttl = name.at(5).toNumber();
+    }
+
+    if (supernodeId == this->GetNode()->GetId()) {
+      if (consumer != 0) {
+        if (consumer->InRotationCooldown())
+          return; // handed the role over, the member finds the successor
+
+        uint32_t role = name.size() > 7 ? name.at(6).toNumber() : Clusterconsumer::SCI_PRIMARY;
+        uint32_t other = name.size() > 7 ? name.at(7).toNumber() : NeighbourhoodInfo::UNKNOWN;
+
+        // a secondary supernode only keeps a copy, it does not take the member into its domain
+        if (role != Clusterconsumer::SCI_BACKUP
+            && !consumer->AdmitMember(name.at(3).toNumber(), role == Clusterconsumer::SCI_FAILOVER)) {
+          uint8_t status = Clusterconsumer::SCI_REFUSED;
+          data->setContent(make_shared< ::ndn::Buffer>(&status, 1));
+        }
+        else {
+          consumer->BecomeSupernode(interest->getSCIFace());
+          if (role == Clusterconsumer::SCI_BACKUP)
+            consumer->CountMember(name.at(3).toNumber());
+
+          if (role == Clusterconsumer::SCI_PRIMARY && other != NeighbourhoodInfo::UNKNOWN)
+            consumer->SetMemberBackup(other, interest->getSCIFace());
+          else if (role == Clusterconsumer::SCI_FAILOVER)
+            consumer->TakeOver(other);
+        }
+      }
+    }
+    else {
+      // k-hop: confirm on behalf of a supernode further away if it is on the way
+      if (consumer == 0 || !consumer->RelaySupernode(name.at(3).toNumber(), supernodeId, ttl))
+        return;
+      data->setNodeId(supernodeId);
+    }
+  }
+  else if (Name("/localhop/Cluster/AGG").isPrefixOf(interest->getName()) && interest->hasBf())
+  {
+    // /localhop/Cluster/AGG/<origin>/<level>/<supernode>/<ttl>/<seq>
+    const Name& name = interest->getName();
+    Ptr<Clusterconsumer> consumer = Clusterconsumer::GetClusterconsumer(this->GetNode());
+    if (consumer == 0 || name.size() < 7)
+      return;
+
+    uint32_t origin = name.at(3).toNumber();
+    uint32_t level = name.at(4).toNumber();
+    uint32_t supernodeId = name.at(5).toNumber();
+    if (supernodeId == this->GetNode()->GetId())
+      consumer->ReceiveAggregate(origin, level, interest->getBf());
+    else if (!consumer->RelayAggregate(origin, level, supernodeId, name.at(6).toNumber(),
+                                       interest->getBf()))
+      return;
+  }
+  else if (Name("/localhop/Cluster/DST").isPrefixOf(interest->getName()) && interest->hasBf())
+  {
+    // /localhop/Cluster/DST/<origin>/<via>/<supernode>/<hops>/<ttl>/<seq>, not answered
+    const Name& name = interest->getName();
+    Ptr<Clusterconsumer> consumer = Clusterconsumer::GetClusterconsumer(this->GetNode());
+    if (consumer == 0 || name.size() < 9)
+      return;
+
+    uint32_t origin = name.at(3).toNumber();
+    uint32_t via = name.at(4).toNumber();
+    uint32_t supernodeId = name.at(5).toNumber();
+    uint32_t hops = name.at(6).toNumber();
+    consumer->ReceiveDistantFilter(origin, via, interest->getSCIFace(), hops, interest->getBf());
+    if (supernodeId != this->GetNode()->GetId())
+      consumer->RelayDistantFilter(origin, via, supernodeId, hops, name.at(7).toNumber(),
+                                   interest->getBf());
+    return;
+  }
+  else if (Name("/localhop/Cluster/BKP").isPrefixOf(interest->getName()) && interest->hasBf())
+  {
+    // /localhop/Cluster/BKP/<origin>/<backup>/<seq>, relayed by a member of both domains
+    const Name& name = interest->getName();
+    Ptr<Clusterconsumer> consumer = Clusterconsumer::GetClusterconsumer(this->GetNode());
+    if (consumer == 0 || name.size() < 6)
+      return;
+
+    uint32_t origin = name.at(3).toNumber();
+    uint32_t backupId = name.at(4).toNumber();
+    if (backupId == this->GetNode()->GetId())
+      consumer->ReceiveBackupFilter(origin, interest->getBf());
+    else if (!consumer->RelayBackupFilter(origin, backupId, interest->getBf()))
+      return;
+  }
+  else if (Name("/localhop/IIM").isPrefixOf(interest->getName()) && interest->hasBf())
+  {
+    // /localhop/IIM/<supernode>/<seq>: keep the supernode's filter for service routing, the
+    // reply with this node's own filter does not come from this app
+    const Name& name = interest->getName();
+    Ptr<Clusterconsumer> consumer = Clusterconsumer::GetClusterconsumer(this->GetNode());
+    if (consumer != 0 && name.size() > 3)
+      consumer->ReceiveSupernodeFilter(name.at(2).toNumber(), interest->getSCIFace(),
+                                       interest->getBf());
+    return;
+  }
+  else if (Name("/localhop/Cluster/RES").isPrefixOf(interest->getName()) && interest->hasBf())
+  {
+    // /localhop/Cluster/RES/<origin>/<supernode>/<ttl>/<shard>/<seq>, relayed on a k-hop path
+    const Name& name = interest->getName();
+    Ptr<Clusterconsumer> consumer = Clusterconsumer::GetClusterconsumer(this->GetNode());
+    if (consumer == 0 || name.size() < 8)
+      return;
+
+    uint32_t origin = name.at(3).toNumber();
+    uint32_t supernodeId = name.at(4).toNumber();
+    uint32_t shard = name.at(6).toNumber();
+    if (supernodeId == this->GetNode()->GetId())
+      consumer->ReceiveServiceFilter(origin, interest->getSCIFace(), shard, interest->getBf());
+    else if (!consumer->RelayServiceFilter(origin, supernodeId, name.at(5).toNumber(), shard,
+                                           interest->getBf()))
+      return;
+  }
+  else if (Name("/localhop/Cluster/FRR").isPrefixOf(interest->getName()))
+  {
+    // /localhop/Cluster/FRR/<origin>/<supernode>/<seq>: this supernode's filter is noisy
+    const Name& name = interest->getName();
+    Ptr<Clusterconsumer> consumer = Clusterconsumer::GetClusterconsumer(this->GetNode());
+    if (consumer == 0 || name.size() < 6 || name.at(4).toNumber() != this->GetNode()->GetId()
+        || !consumer->IsSupernode())
+      return;
+
+    consumer->RebuildFilter(name.at(3).toNumber());
+  }
+  else if (Name("/localhop/Cluster/IIS").isPrefixOf(interest->getName()) && interest->hasBf())
+  {
+    // /localhop/Cluster/IIS/<supernode>/<shard>/<capacity>/<seq>: an IIM segment, not answered
+    const Name& name = interest->getName();
+    Ptr<Clusterconsumer> consumer = Clusterconsumer::GetClusterconsumer(this->GetNode());
+    if (consumer != 0 && name.size() > 6)
+      consumer->ReceiveSupernodeShard(name.at(3).toNumber(), interest->getSCIFace(),
+                                      name.at(4).toNumber(), name.at(5).toNumber(),
+                                      interest->getBf());
+    return;
+  }
+  else if (Name("/localhop/Cluster/SHO").isPrefixOf(interest->getName()) && interest->hasBf())
+  {
+    // /localhop/Cluster/SHO/<from>/<to>/<seq>: an overloaded supernode hands its role over
+    const Name& name = interest->getName();
+    Ptr<Clusterconsumer> consumer = Clusterconsumer::GetClusterconsumer(this->GetNode());
+    if (consumer == 0 || name.size() < 6 || name.at(4).toNumber() != this->GetNode()->GetId()
+        || consumer->InRotationCooldown())
+      return;
+
+    consumer->AcceptHandover(name.at(3).toNumber(), interest->getSCIFace(), interest->getBf());
+  } else { return; }
+
+
+  // to create real wire encoding
+  data->wireEncode();
+
+  m_transmittedDatas(data, this, m_face);
+  m_appLink->onReceiveData(*data);
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,79 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "filter-trust.hpp"
+
+namespace ns3 {
+namespace ndn {
+
+namespace {
+
+// weight of a new sample, about the last 10 count
+const double ALPHA = 0.1;
+
+} // namespace
+
+const uint32_t FilterTrust::MIN_SAMPLES;
+
+FilterTrust::FilterTrust(double noisyRate, Time holdDown)
+  : m_noisyRate(noisyRate)
+  , m_holdDown(holdDown)
+{
+}
+
+void
+FilterTrust::Record(uint32_t supernodeId, bool falsePositive)
+{
+  Source& source = m_sources[supernodeId];
+  double sample = falsePositive ? 1.0 : 0.0;
+  // the plain mean until the average has something to weigh against
+  if (source.samples < MIN_SAMPLES)
+    source.rate += (sample - source.rate) / (source.samples + 1);
+  else
+    source.rate += ALPHA * (sample - source.rate);
+  source.samples++;
+}
+
+double
+FilterTrust::GetRate(uint32_t supernodeId, double predicted) const
+{
+  auto source = m_sources.find(supernodeId);
+  if (source == m_sources.end() || source->second.samples < MIN_SAMPLES)
+    return predicted;
+  return source->second.rate;
+}
+
+bool
+FilterTrust::ShouldRebuild(uint32_t supernodeId, Time now)
+{
+  auto source = m_sources.find(supernodeId);
+  if (m_noisyRate <= 0.0 || source == m_sources.end() || source->second.samples < MIN_SAMPLES
+      || source->second.rate <= m_noisyRate
+      || (source->second.asked && now - source->second.askedAt < m_holdDown))
+    return false;
+
+  source->second.asked = true;
+  source->second.askedAt = now;
+  source->second.rate = 0.0;
+  source->second.samples = 0;
+  return true;
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,134 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef NEIGHBOURHOOD
+#define NEIGHBOURHOOD
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief What a node tells its neighbours about itself, carried in the content of its
+ *        CII replies
+ *
+ * Knowing the 1-hop set of every neighbour gives each node its 2-hop neighbourhood. The
+ * encoding is a sequence of LEB128 varints,
+ *
+ *     supernodeId + 1, flags, span + 1, count, neighbours[0], gaps...,
+ *     count, (supernode id gap, distance)..., count, (span, node id)...,
+ *     count, (level, supernode id, distance, span + 1, parent + 1)..., backupId + 1, score, domainSize
+ *
+ * where the sorted neighbour and supernode ids are stored as gaps to their predecessor, so a
+ * CII reply from a node with dense ids costs about one byte per neighbour. The supernode and
+ * candidate lists are only filled in k-hop mode (K > 1), the overlay list only with more
+ * than one level of supernodes (MaxLevel > 1).
+ */
+struct NeighbourhoodInfo
+{
+  enum Flags {
+    SUPERNODE = 1,
+    MARKED = 2,   ///< Wu-Li marked (CDS), before pruning
+    CONNECTOR = 4 ///< kept in the CDS backbone without being a supernode
+  };
+
+  static const uint32_t UNKNOWN = std::numeric_limits<uint32_t>::max();
+
+  uint32_t supernodeId; ///< UNKNOWN if not in a domain yet
+  uint32_t backupId;    ///< secondary supernode with DoubleDomination, UNKNOWN if none
+  uint32_t flags;
+  uint32_t span; ///< undominated nodes in the closed neighbourhood, UNKNOWN before the first round
+  uint32_t score; ///< weighted capability in thousandths, see Clusterconsumer::GetScore
+  uint32_t domainSize; ///< members of this supernode, 0 for other nodes
+  /// (span, node id) of a supernode nomination, (0, 0) for none; compares by span, then id
+  typedef std::pair<uint32_t, uint32_t> Candidate;
+
+  /// A level-`level` supernode as seen through the overlay distance vector
+  struct OverlayEntry
+  {
+    uint32_t level;
+    uint32_t supernodeId;
+    uint32_t distance;
+    uint32_t span;   ///< in the level + 1 election, UNKNOWN before its first round
+    uint32_t parent; ///< level + 1 supernode, UNKNOWN if none yet
+
+    bool
+    operator<(const OverlayEntry& other) const
+    {
+      return level < other.level || (level == other.level && supernodeId < other.supernodeId);
+    }
+
+    bool
+    operator==(const OverlayEntry& other) const
+    {
+      return level == other.level && supernodeId == other.supernodeId
+             && distance == other.distance && span == other.span && parent == other.parent;
+    }
+  };
+
+  std::vector<uint32_t> neighbours; ///< sorted node ids
+
+  /// (supernode id, hops), sorted by id: supernodes this node reaches in less than K hops
+  std::vector<std::pair<uint32_t, uint32_t>> supernodes;
+
+  /// best nomination within d hops of this node, for d = 0..K-1
+  std::vector<Candidate> candidates;
+
+  /// supernodes of every level below MaxLevel within their overlay radius, sorted
+  std::vector<OverlayEntry> overlay;
+
+  NeighbourhoodInfo();
+
+  bool
+  IsNeighbour(uint32_t nodeId) const;
+
+  shared_ptr< ::ndn::Buffer>
+  Encode() const;
+
+  /**
+   * @returns false if the buffer does not hold a valid encoding
+   */
+  bool
+  Decode(const uint8_t* buffer, size_t length);
+
+  bool
+  operator==(const NeighbourhoodInfo& other) const
+  {
+    return supernodeId == other.supernodeId && backupId == other.backupId && flags == other.flags
+           && span == other.span && score == other.score && domainSize == other.domainSize
+           && neighbours == other.neighbours && supernodes == other.supernodes
+           && candidates == other.candidates && overlay == other.overlay;
+  }
+
+  bool
+  operator!=(const NeighbourhoodInfo& other) const
+  {
+    return !(*this == other);
+  }
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif
@@ -0,0 +1,107 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef RESOLUTIONCACHE
+#define RESOLUTIONCACHE
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+#include "ns3/nstime.h"
+
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief Bounded cache of service resolutions at a supernode
+ *
+ * Maps a service name to the face a Data came back on (positive entry) or marks it as
+ * Nacked (negative entry), each until its expiry. Entries live in a flat open-addressing
+ * table with linear probing, at most half full, keyed by the 64-bit hash of the name; a
+ * hash collision is taken as a match. When the cache holds its capacity, CLOCK evicts: the
+ * hand sweeps the table, clearing the reference bit set by every hit, and evicts the first
+ * entry that has not been hit since the last sweep.
+ */
+class ResolutionCache {
+public:
+  struct Entry
+  {
+    uint64_t key;
+    uint32_t face;  ///< for positive entries
+    Time expiry;
+    Time latency;   ///< of the resolution that created a positive entry
+    bool negative;
+    bool referenced;
+    bool used;
+  };
+
+  /**
+   * @param capacity entries, 0 for a cache that never holds any
+   */
+  explicit ResolutionCache(size_t capacity = 0);
+
+  /**
+   * @brief Look a service up, dropping it if it has expired
+   * @returns 0 on a miss
+   */
+  const Entry*
+  Find(const Name& service, Time now);
+
+  void
+  InsertPositive(const Name& service, uint32_t face, Time latency, Time expiry);
+
+  void
+  InsertNegative(const Name& service, Time expiry);
+
+  void
+  Erase(const Name& service);
+
+  size_t
+  GetSize() const;
+
+  size_t
+  GetCapacity() const;
+
+private:
+  size_t
+  Lookup(uint64_t key) const;
+
+  Entry&
+  Insert(uint64_t key);
+
+  void
+  Evict();
+
+  void
+  EraseSlot(size_t slot);
+
+  static uint64_t
+  Hash(const Name& service);
+
+private:
+  std::vector<Entry> m_slots; // power of two, at least twice the capacity
+  size_t m_capacity;
+  size_t m_size;
+  size_t m_hand; // CLOCK
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif
@@ -0,0 +1,92 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef RESOURCECLASS
+#define RESOURCECLASS
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+#include "ns3/ndnSIM/ndn-cxx/bloom_filter.hpp"
+
+#include <cstdint>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief Quantised resources of a service provider, advertised in the domain filters
+ *
+ * Cpu (relative capacity) and Ram (GB) fall into CLASSES classes each, doubling from one
+ * unit: class 0 is below 1, class c covers [2^(c-1), 2^c), and the last class is open-ended.
+ * A provider inserts the service name and the key `<service>/<cpu class>/<ram class>` into
+ * its filter, so a supernode answers "service X with at least Y" from its domain filter with
+ * at most CLASSES^2 probes, without asking its members.
+ */
+class ResourceClass {
+public:
+  static const uint32_t CLASSES = 4;
+
+  static uint32_t
+  Quantise(double value)
+  {
+    uint32_t cls = 0;
+    for (double bound = 1.0; cls + 1 < CLASSES && value >= bound; bound *= 2)
+      cls++;
+    return cls;
+  }
+
+  static Name
+  MakeKey(const Name& service, uint32_t cpuClass, uint32_t ramClass)
+  {
+    return Name(service).appendNumber(cpuClass).appendNumber(ramClass);
+  }
+
+  /**
+   * @brief Insert a service and its resource key into a filter
+   */
+  static void
+  Insert(bloom_filter& filter, const Name& service, double cpu, double ram)
+  {
+    filter.insert(service.toUri());
+    filter.insert(MakeKey(service, Quantise(cpu), Quantise(ram)).toUri());
+  }
+
+  /**
+   * @brief Whether the filter holds the service at some class at least minCpu / minRam,
+   *        false positives included
+   */
+  static bool
+  Contains(const bloom_filter& filter, const Name& service, uint32_t minCpu, uint32_t minRam)
+  {
+    if (!filter.contains(service.toUri()))
+      return false;
+
+    for (uint32_t cpu = minCpu; cpu < CLASSES; cpu++) {
+      for (uint32_t ram = minRam; ram < CLASSES; ram++) {
+        if (filter.contains(MakeKey(service, cpu, ram).toUri()))
+          return true;
+      }
+    }
+    return false;
+  }
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif
@@ -0,0 +1,129 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef SHARDEDFILTER
+#define SHARDEDFILTER
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+#include "ns3/ndnSIM/ndn-cxx/bloom_filter.hpp"
+#include "ns3/nstime.h"
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief Domain filter split into shards by the hash of the first name component
+ *
+ * Every shard has its own capacity, so a service family with many names gets a large table
+ * while the others stay small, and a lookup touches only the shard of its name. Members build
+ * their service filters per shard at the capacity the supernode announces (MakeShape), the
+ * supernode ORs them in with Merge.
+ *
+ * Update, once per IIM period, grows a shard whose table predicts more than twice the target
+ * false positive rate: the announced capacity doubles, the filters merged over the next period
+ * fill a fresh table of that size, and then it replaces the old one, which serves lookups in
+ * the meantime. Restart does the same at the current capacities, for a rebuild.
+ */
+class ShardedFilter {
+public:
+  static const uint32_t SHARDS = 16;
+  static const uint64_t MIN_CAPACITY = 64;
+
+  static uint32_t
+  GetShard(const Name& name);
+
+  /**
+   * @brief Empty filter of the shape members and supernode agree on for a capacity
+   */
+  static bloom_filter
+  MakeShape(uint64_t capacity);
+
+  /**
+   * @brief False positive rate predicted from the share of set bits, also for ORed tables
+   */
+  static double
+  GetFpp(const bloom_filter& filter);
+
+  /**
+   * @param fpp target false positive rate of every shard
+   */
+  explicit ShardedFilter(double fpp);
+
+  /**
+   * @brief OR a member's filter into a shard, dropped unless it has the shape of the shard or
+   *        of the one being filled
+   */
+  void
+  Merge(uint32_t shard, const bloom_filter& filter);
+
+  /**
+   * @returns 0 if the shard is empty
+   */
+  const bloom_filter*
+  Get(uint32_t shard) const;
+
+  /**
+   * @brief Capacity members should build the shard's filters at
+   */
+  uint64_t
+  GetCapacity(uint32_t shard) const;
+
+  void
+  Update(Time now, Time period);
+
+  void
+  Restart(Time now);
+
+  /**
+   * @brief Shards whose table or capacity changed since the last call, or all of them
+   */
+  std::vector<uint32_t>
+  TakeChanged(bool all);
+
+private:
+  struct Shard
+  {
+    bloom_filter filter;
+    uint64_t capacity;
+    bool filling;
+    Time fillStart;
+    bloom_filter fresh;
+    uint64_t freshMerges;
+    bool changed;
+  };
+
+  Shard&
+  GetOrCreate(uint32_t shard);
+
+  void
+  StartFill(Shard& shard, uint64_t capacity, Time now);
+
+private:
+  double m_fpp;
+  std::map<uint32_t, Shard> m_shards;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif
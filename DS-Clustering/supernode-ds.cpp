@@ -1,236 +1,543 @@
-/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
-/**
- * Copyright (c) 2011-2015  Regents of the University of California.
- *
- * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
- * contributors.
- *
- * ndnSIM is free software: you can redistribute it and/or modify it under the terms
- * of the GNU General Public License as published by the Free Software Foundation,
- * either version 3 of the License, or (at your option) any later version.
- *
- * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
- * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
- * PURPOSE.  See the GNU General Public License for more details.
- *
- * You should have received a copy of the GNU General Public License along with
- * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
- **/
-
-#include "supernode-ds.hpp"
-#include "ns3/ptr.h"
-#include "ns3/log.h"
-#include "ns3/simulator.h"
-#include "ns3/packet.h"
-#include "ns3/callback.h"
-#include "ns3/string.h"
-#include "ns3/boolean.h"
-#include "ns3/uinteger.h"
-#include "ns3/integer.h"
-#include "ns3/double.h"
-
-#include <ndn-cxx/lp/tags.hpp>
-
-NS_LOG_COMPONENT_DEFINE("Supernode");
-
-namespace ns3 {
-namespace ndn {
-
-NS_OBJECT_ENSURE_REGISTERED(Supernode);
-
-TypeId
-Supernode::GetTypeId(void)
-{
-  static TypeId tid =
-    TypeId("ns3::ndn::Supernode")
-      .SetGroupName("Ndn")
-      .SetParent<Consumer>()
-      .AddConstructor<Supernode>()
-
-      .AddAttribute("Frequency", "Frequency of interest packets", StringValue("0.1"),
-                    MakeDoubleAccessor(&Supernode::m_frequency), MakeDoubleChecker<double>())
-
-      .AddAttribute("Randomize",
-                    "Type of send time randomization: none (default), uniform, exponential",
-                    StringValue("none"),
-                    MakeStringAccessor(&Supernode::SetRandomize, &Supernode::GetRandomize),
-                    MakeStringChecker())
-
-      .AddAttribute("MaxSeq", "Maximum sequence number to request",
-                    IntegerValue(std::numeric_limits<uint32_t>::max()),
-                    MakeIntegerAccessor(&Supernode::m_seqMax), MakeIntegerChecker<uint32_t>())
-
-    ;
-
-  return tid;
-}
-
-Supernode::Supernode()
-  : m_frequency(0.1)
-  , m_firstTime(true)
-  , domainFilter(PEC, FPP, UNIVERSAL_SEED) 
-{
-  m_seqMax = std::numeric_limits<uint32_t>::max();
-  m_interestName = ndn::Name("ndn:/localhop/IIM");
-}
-
-Supernode::~Supernode()
-{
-}
-
-void
-Supernode::ScheduleNextPacket()
-{
-  // double mean = 8.0 * m_payloadSize / m_desiredRate.GetBitRate ();
-  // std::cout << "next: " << Simulator::Now().ToDouble(Time::S) + mean << "s\n";
-
-  if (m_firstTime) {
-    m_sendEvent = Simulator::Schedule(Seconds(0.0), &Supernode::SendPacket, this);
-    m_firstTime = false;
-  }
-  else if (!m_sendEvent.IsRunning())
-    m_sendEvent = Simulator::Schedule((m_random == 0) ? Seconds(1.0 / m_frequency)
-                                                      : Seconds(m_random->GetValue()),
-                                      &Supernode::SendPacket, this);
-}
-
-void
-Supernode::SendPacket()
-{
-  if (!m_active)
-    return;
-
-  //NS_LOG_FUNCTION_NOARGS();
-
-  uint32_t seq = std::numeric_limits<uint32_t>::max(); // invalid
-
-  while (m_retxSeqs.size()) {
-    seq = *m_retxSeqs.begin();
-    m_retxSeqs.erase(m_retxSeqs.begin());
-    break;
-  }
-
-  if (seq == std::numeric_limits<uint32_t>::max()) {
-    if (m_seqMax != std::numeric_limits<uint32_t>::max()) {
-      if (m_seq >= m_seqMax) {
-        return; // we are totally done
-      }
-    }
-
-    seq = m_seq++;
-  }
-
-  shared_ptr<Name> nameWithSequence = make_shared<Name>(m_interestName);
-  uint32_t rand = m_rand->GetValue(0, std::numeric_limits<uint32_t>::max());
-  nameWithSequence->appendSequenceNumber(rand);
-
-  // shared_ptr<Interest> interest = make_shared<Interest> ();
-  shared_ptr<Interest> interest = make_shared<Interest>();
-  interest->setNonce(rand);
-  interest->setName(*nameWithSequence);
-  // time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
-  // interest->setInterestLifetime(interestLifeTime);
-
-  interest->setBfComponents(domainFilter.size(), domainFilter.table(), domainFilter.element_count(), domainFilter.salt_count());
-
-  NS_LOG_INFO("Sending IIM");
-  
-  WillSendOutInterest(seq);
-
-  m_transmittedInterests(interest, this, m_face);
-  m_appLink->onReceiveInterest(*interest);
-
-  ScheduleNextPacket();
-}
-
-
-void
-Supernode::SetRandomize(const std::string& value)
-{
-  if (value == "uniform") {
-    m_random = CreateObject<UniformRandomVariable>();
-    m_random->SetAttribute("Min", DoubleValue(0.0));
-    m_random->SetAttribute("Max", DoubleValue(2 * 1.0 / m_frequency));
-  }
-  else if (value == "exponential") {
-    m_random = CreateObject<ExponentialRandomVariable>();
-    m_random->SetAttribute("Mean", DoubleValue(1.0 / m_frequency));
-    m_random->SetAttribute("Bound", DoubleValue(50 * 1.0 / m_frequency));
-  }
-  else
-    m_random = 0;
-
-  m_randomType = value;
-}
-
-std::string
-Supernode::GetRandomize() const
-{
-  return m_randomType;
-}
-
-
-void
-Supernode::OnData(shared_ptr<const Data> data)
-{
-  if (!m_active)
-    return;
-
-  App::OnData(data); // tracing inside
-
-  uint32_t seq = data->getName().at(-1).toSequenceNumber();
-  if (data->hasBf()) {
-    NS_LOG_INFO("Bloom filter received from " << data->getNodeId());
-    bloom_filter filter = data->getBf();
-    domainFilter |= filter;
-  }
-  else {
-    NS_LOG_INFO("DATA for sequence number " << seq);
-  }
-
-  int hopCount = 0;
-  auto hopCountTag = data->getTag<lp::HopCountTag>();
-  if (hopCountTag != nullptr) { // e.g., packet came from local node's cache
-    hopCount = *hopCountTag;
-  }
-
-  SeqTimeoutsContainer::iterator entry = m_seqLastDelay.find(seq);
-  if (entry != m_seqLastDelay.end()) {
-    m_lastRetransmittedInterestDataDelay(this, seq, Simulator::Now() - entry->time, hopCount);
-  }
-
-  entry = m_seqFullDelay.find(seq);
-  if (entry != m_seqFullDelay.end()) {
-    m_firstInterestDataDelay(this, seq, Simulator::Now() - entry->time, m_seqRetxCounts[seq], hopCount);
-  }
-
-  m_seqRetxCounts.erase(seq);
-  m_seqFullDelay.erase(seq);
-  m_seqLastDelay.erase(seq);
-
-  m_seqTimeouts.erase(seq);
-  m_retxSeqs.erase(seq);
-
-  m_rtt->AckSeq(SequenceNumber32(seq));
-}
-
-void
-Supernode::OnNack(shared_ptr<const lp::Nack> nack)
-{
-  App::OnNack(nack);
-  NS_LOG_INFO("No service provider in this domain");
-}
-
-void
-Supernode::StartApplication() // Called at time specified by Start
-{
-  NS_LOG_FUNCTION_NOARGS();
-
-  // do base stuff
-  App::StartApplication();
-
-  ScheduleNextPacket();
-}
-
-} // namespace ndn
-} // namespace ns3
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "supernode-ds.hpp"
+#include "bloom-filter-util.hpp"
+#include "member-filter-table.hpp"
+#include "ns3/ptr.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "ns3/callback.h"
+#include "ns3/string.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/integer.h"
+#include "ns3/double.h"
+
+#include <ndn-cxx/lp/tags.hpp>
+#include <utility>
+
+NS_LOG_COMPONENT_DEFINE("Supernode");
+
+namespace ns3 {
+namespace ndn {
+
+NS_OBJECT_ENSURE_REGISTERED(Supernode);
+
+namespace {
+
+const uint32_t SEGMENT_REFRESH = 5;
+
+} // namespace
+
+TypeId
+Supernode::GetTypeId(void)
+{
+  static TypeId tid =
+    TypeId("ns3::ndn::Supernode")
+      .SetGroupName("Ndn")
+      .SetParent<Consumer>()
+      .AddConstructor<Supernode>()
+
+      .AddAttribute("Frequency", "Frequency of interest packets", StringValue("0.1"),
+                    MakeDoubleAccessor(&Supernode::m_frequency), MakeDoubleChecker<double>())
+
+      .AddAttribute("Randomize",
+                    "Type of send time randomization: none (default), uniform, exponential",
+                    StringValue("none"),
+                    MakeStringAccessor(&Supernode::SetRandomize, &Supernode::GetRandomize),
+                    MakeStringChecker())
+
+      .AddAttribute("MaxSeq", "Maximum sequence number to request",
+                    IntegerValue(std::numeric_limits<uint32_t>::max()),
+                    MakeIntegerAccessor(&Supernode::m_seqMax), MakeIntegerChecker<uint32_t>())
+
+      .AddAttribute("EpochPeriods",
+                    "IIM periods per epoch of the domain filter: bits no member re-advertised "
+                    "in the current or the previous epoch are dropped at the rollover; 0 keeps "
+                    "them until a rebuild",
+                    UintegerValue(0),
+                    MakeUintegerAccessor(&Supernode::m_epochPeriods), MakeUintegerChecker<uint32_t>())
+
+      .AddAttribute("MemberRounds",
+                    "IIM periods a member's filter is kept without a new reply: above 0 the "
+                    "supernode keeps one filter per member and recomputes the domain filter "
+                    "from them (EpochPeriods is then ignored), 0 ORs the replies straight in",
+                    UintegerValue(0),
+                    MakeUintegerAccessor(&Supernode::m_memberRounds), MakeUintegerChecker<uint32_t>())
+
+      .AddTraceSource("FilterChanged", "Domain filter gained new bits",
+                      MakeTraceSourceAccessor(&Supernode::m_filterChanged),
+                      "ns3::ndn::Supernode::FilterChangedCallback")
+
+    ;
+
+  return tid;
+}
+
+Supernode::Supernode()
+  : m_frequency(0.1)
+  , m_firstTime(true)
+  , domainFilter(PEC, FPP, UNIVERSAL_SEED) 
+  , m_quiesced(false)
+  , m_merges(0)
+  , m_rebuilding(false)
+  , m_rebuildFilter(PEC, FPP, UNIVERSAL_SEED)
+  , m_rebuildMerges(0)
+  , m_shards(FPP)
+  , m_segmentRefresh(0)
+  , m_epochPeriods(0)
+  , m_epochAge(0)
+  , m_epochFilter(PEC, FPP, UNIVERSAL_SEED)
+  , m_memberRounds(0)
+  , m_memberFilters(domainFilter)
+  , m_otherFilter(PEC, FPP, UNIVERSAL_SEED)
+  , m_otherAge(0)
+  , m_otherRecent(PEC, FPP, UNIVERSAL_SEED)
+{
+  m_seqMax = std::numeric_limits<uint32_t>::max();
+  m_interestName = ndn::Name("ndn:/localhop/IIM");
+}
+
+Supernode::~Supernode()
+{
+}
+
+void
+Supernode::Quiesce()
+{
+  NS_LOG_FUNCTION_NOARGS();
+
+  m_quiesced = true;
+  Simulator::Cancel(m_sendEvent);
+}
+
+const bloom_filter&
+Supernode::GetDomainFilter() const
+{
+  return domainFilter;
+}
+
+void
+Supernode::SetDomainFilter(const bloom_filter& filter)
+{
+  // kept for this epoch and the next (or MemberRounds periods and the next MemberRounds with
+  // a member table), then only what the members re-advertise
+  domainFilter = filter;
+  m_epochFilter = filter;
+  m_otherFilter = filter;
+  m_otherRecent = filter;
+}
+
+void
+Supernode::SetChildFilter(uint32_t level, uint32_t nodeId, const bloom_filter& filter)
+{
+  NS_LOG_DEBUG("Level-" << level << " aggregate from " << nodeId);
+  m_childFilters[level][nodeId] = filter;
+}
+
+bloom_filter
+Supernode::GetLevelFilter(uint32_t level) const
+{
+  if (level <= 1)
+    return domainFilter;
+
+  // children of the same level share the shape, others are skipped by |=
+  MutableBloomFilter aggregate(GetLevelFilter(level - 1));
+  auto children = m_childFilters.find(level - 1);
+  if (children != m_childFilters.end()) {
+    for (const auto& child : children->second)
+      aggregate |= child.second;
+  }
+  aggregate.Fold();
+  return aggregate;
+}
+
+void
+Supernode::MergeFilter(const bloom_filter& filter)
+{
+  bloom_filter previous = domainFilter;
+  domainFilter |= filter;
+  m_merges++;
+  if (m_epochPeriods > 0)
+    m_epochFilter |= filter;
+  if (m_memberRounds > 0) {
+    m_otherFilter |= filter;
+    m_otherRecent |= filter;
+  }
+  if (m_rebuilding) {
+    m_rebuildFilter |= filter;
+    m_rebuildMerges++;
+  }
+  if (!(domainFilter == previous))
+    m_filterChanged(this->GetNode()->GetId(), domainFilter.element_count());
+}
+
+void
+Supernode::MergeMemberFilter(uint32_t memberId, const bloom_filter& filter)
+{
+  if (m_memberRounds == 0 || !m_memberFilters.Update(memberId, filter, Simulator::Now())) {
+    MergeFilter(filter);
+    return;
+  }
+
+  m_merges++;
+  RecomputeDomainFilter();
+}
+
+void
+Supernode::RemoveMember(uint32_t memberId)
+{
+  if (m_memberFilters.Remove(memberId)) {
+    NS_LOG_INFO("Filter of member " << memberId << " dropped");
+    RecomputeDomainFilter();
+  }
+}
+
+void
+Supernode::RecomputeDomainFilter()
+{
+  MutableBloomFilter aggregate(domainFilter);
+  aggregate.Assign(m_memberFilters.GetAggregate(), m_memberFilters.GetTableBytes(),
+                   m_memberFilters.GetElementCount());
+  aggregate |= m_otherFilter;
+  if (aggregate == domainFilter)
+    return;
+
+  domainFilter = aggregate;
+  m_filterChanged(this->GetNode()->GetId(), domainFilter.element_count());
+}
+
+uint64_t
+Supernode::GetMergeCount() const
+{
+  return m_merges;
+}
+
+bool
+Supernode::HasUpkeep() const
+{
+  return m_epochPeriods > 0 || m_memberRounds > 0 || m_rebuilding;
+}
+
+void
+Supernode::Resume()
+{
+  if (!m_quiesced)
+    return;
+
+  m_quiesced = false;
+  ScheduleNextPacket();
+}
+
+void
+Supernode::SetBackupFilter(uint32_t supernodeId, const bloom_filter& filter)
+{
+  m_backupFilters[supernodeId] = filter;
+}
+
+void
+Supernode::TakeOver(uint32_t supernodeId)
+{
+  auto backup = m_backupFilters.find(supernodeId);
+  if (backup == m_backupFilters.end()) {
+    NS_LOG_INFO("No warm copy of the filter of " << supernodeId);
+    return;
+  }
+
+  NS_LOG_INFO("Taking over the domain of " << supernodeId);
+  bloom_filter previous = domainFilter;
+  domainFilter |= backup->second;
+  if (m_rebuilding)
+    m_rebuildFilter |= backup->second;
+  if (m_epochPeriods > 0)
+    m_epochFilter |= backup->second;
+  if (m_memberRounds > 0) {
+    m_otherFilter |= backup->second;
+    m_otherRecent |= backup->second;
+  }
+  m_backupFilters.erase(backup);
+  if (!(domainFilter == previous))
+    m_filterChanged(this->GetNode()->GetId(), domainFilter.element_count());
+}
+
+void
+Supernode::Rebuild()
+{
+  if (m_rebuilding)
+    return;
+
+  NS_LOG_INFO("Rebuilding the domain filter");
+  if (m_memberRounds > 0) {
+    // exact: the members that replied during the last period
+    m_memberFilters.Expire(Simulator::Now() - Seconds(1.0 / m_frequency));
+    m_otherFilter.clear();
+    m_otherRecent.clear();
+    RecomputeDomainFilter();
+    m_shards.Restart(Simulator::Now());
+    return;
+  }
+
+  m_rebuilding = true;
+  m_rebuildStart = Simulator::Now();
+  m_rebuildFilter = bloom_filter(PEC, FPP, UNIVERSAL_SEED);
+  m_rebuildMerges = 0;
+  m_shards.Restart(Simulator::Now());
+}
+
+void
+Supernode::MergeShard(uint32_t shard, const bloom_filter& filter)
+{
+  m_shards.Merge(shard, filter);
+  m_merges++;
+}
+
+const ShardedFilter&
+Supernode::GetShards() const
+{
+  return m_shards;
+}
+
+void
+Supernode::SendSegment(uint32_t shard)
+{
+  const bloom_filter* filter = m_shards.Get(shard);
+  if (filter == 0)
+    return;
+
+  // /localhop/Cluster/IIS/<supernode>/<shard>/<capacity>/<seq>, not answered
+  shared_ptr<Name> nameWithSequence = make_shared<Name>("ndn:/localhop/Cluster/IIS");
+  nameWithSequence->appendNumber(this->GetNode()->GetId());
+  nameWithSequence->appendNumber(shard);
+  nameWithSequence->appendNumber(m_shards.GetCapacity(shard));
+  nameWithSequence->appendSequenceNumber(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
+
+  shared_ptr<Interest> interest = make_shared<Interest>();
+  interest->setNonce(m_rand->GetValue(0, std::numeric_limits<uint32_t>::max()));
+  interest->setName(*nameWithSequence);
+  time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
+  interest->setInterestLifetime(interestLifeTime);
+  interest->setBfComponents(filter->size(), filter->table(), filter->element_count(), filter->salt_count());
+
+  NS_LOG_INFO("Sending IIM segment " << shard);
+
+  m_transmittedInterests(interest, this, m_face);
+  m_appLink->onReceiveInterest(*interest);
+}
+
+void
+Supernode::ScheduleNextPacket()
+{
+  // double mean = 8.0 * m_payloadSize / m_desiredRate.GetBitRate ();
+  // std::cout << "next: " << Simulator::Now().ToDouble(Time::S) + mean << "s\n";
+
+  if (m_firstTime) {
+    m_sendEvent = Simulator::Schedule(Seconds(0.0), &Supernode::SendPacket, this);
+    m_firstTime = false;
+  }
+  else if (!m_sendEvent.IsRunning())
+    m_sendEvent = Simulator::Schedule((m_random == 0) ? Seconds(1.0 / m_frequency)
+                                                      : Seconds(m_random->GetValue()),
+                                      &Supernode::SendPacket, this);
+}
+
+void
+Supernode::SendPacket()
+{
+  if (!m_active || m_quiesced)
+    return;
+
+  // a full period after Rebuild every member has replied into the fresh table
+  if (m_rebuilding && Simulator::Now() - m_rebuildStart >= Seconds(1.0 / m_frequency)) {
+    m_rebuilding = false;
+    if (m_rebuildMerges > 0) {
+      NS_LOG_INFO("Domain filter rebuilt from " << m_rebuildMerges << " filters");
+      domainFilter = m_rebuildFilter;
+      if (m_epochPeriods > 0)
+        domainFilter |= m_epochFilter;
+      m_filterChanged(this->GetNode()->GetId(), domainFilter.element_count());
+    }
+  }
+
+  // members silent for MemberRounds periods take their bits along
+  if (m_memberRounds > 0
+      && m_memberFilters.Expire(Simulator::Now() - Seconds(m_memberRounds / m_frequency)) > 0)
+    RecomputeDomainFilter();
+
+  // and so do the other filters that were not merged again for as long
+  if (m_memberRounds > 0 && ++m_otherAge >= m_memberRounds) {
+    m_otherAge = 0;
+    std::swap(m_otherFilter, m_otherRecent);
+    m_otherRecent.clear();
+    RecomputeDomainFilter();
+  }
+
+  // rollover: the ending epoch becomes the previous one, the one before it is dropped
+  if (m_epochPeriods > 0 && m_memberRounds == 0 && ++m_epochAge >= m_epochPeriods) {
+    m_epochAge = 0;
+    std::swap(domainFilter, m_epochFilter);
+    m_epochFilter.clear();
+    NS_LOG_DEBUG("Epoch rollover, " << domainFilter.element_count() << " elements kept");
+  }
+
+  //NS_LOG_FUNCTION_NOARGS();
+
+  uint32_t seq = std::numeric_limits<uint32_t>::max(); // invalid
+
+  while (m_retxSeqs.size()) {
+    seq = *m_retxSeqs.begin();
+    m_retxSeqs.erase(m_retxSeqs.begin());
+    break;
+  }
+
+  if (seq == std::numeric_limits<uint32_t>::max()) {
+    if (m_seqMax != std::numeric_limits<uint32_t>::max()) {
+      if (m_seq >= m_seqMax) {
+        return; // we are totally done
+      }
+    }
+
+    seq = m_seq++;
+  }
+
+  // /localhop/IIM/<supernode>/<seq>, the id lets receivers tell the supernodes' filters apart
+  shared_ptr<Name> nameWithSequence = make_shared<Name>(m_interestName);
+  uint32_t rand = m_rand->GetValue(0, std::numeric_limits<uint32_t>::max());
+  nameWithSequence->appendNumber(this->GetNode()->GetId());
+  nameWithSequence->appendSequenceNumber(rand);
+
+  // shared_ptr<Interest> interest = make_shared<Interest> ();
+  shared_ptr<Interest> interest = make_shared<Interest>();
+  interest->setNonce(rand);
+  interest->setName(*nameWithSequence);
+  // time::milliseconds interestLifeTime(m_interestLifeTime.GetMilliSeconds());
+  // interest->setInterestLifetime(interestLifeTime);
+
+  interest->setBfComponents(domainFilter.size(), domainFilter.table(), domainFilter.element_count(), domainFilter.salt_count());
+
+  NS_LOG_INFO("Sending IIM");
+  
+  WillSendOutInterest(seq);
+
+  m_transmittedInterests(interest, this, m_face);
+  m_appLink->onReceiveInterest(*interest);
+
+  // the shards that changed, all of them every SEGMENT_REFRESH periods for new neighbours
+  m_shards.Update(Simulator::Now(), Seconds(1.0 / m_frequency));
+  bool refresh = m_segmentRefresh == 0;
+  m_segmentRefresh = refresh ? SEGMENT_REFRESH - 1 : m_segmentRefresh - 1;
+  for (uint32_t shard : m_shards.TakeChanged(refresh))
+    SendSegment(shard);
+
+  ScheduleNextPacket();
+}
+
+
+void
+Supernode::SetRandomize(const std::string& value)
+{
+  if (value == "uniform") {
+    m_random = CreateObject<UniformRandomVariable>();
+    m_random->SetAttribute("Min", DoubleValue(0.0));
+    m_random->SetAttribute("Max", DoubleValue(2 * 1.0 / m_frequency));
+  }
+  else if (value == "exponential") {
+    m_random = CreateObject<ExponentialRandomVariable>();
+    m_random->SetAttribute("Mean", DoubleValue(1.0 / m_frequency));
+    m_random->SetAttribute("Bound", DoubleValue(50 * 1.0 / m_frequency));
+  }
+  else
+    m_random = 0;
+
+  m_randomType = value;
+}
+
+std::string
+Supernode::GetRandomize() const
+{
+  return m_randomType;
+}
+
+
+void
+Supernode::OnData(shared_ptr<const Data> data)
+{
+  if (!m_active)
+    return;
+
+  App::OnData(data); // tracing inside
+
+  uint32_t seq = data->getName().at(-1).toSequenceNumber();
+  if (data->hasBf()) {
+    NS_LOG_INFO("Bloom filter received from " << data->getNodeId());
+    MergeMemberFilter(data->getNodeId(), data->getBf());
+  }
+  else {
+    NS_LOG_INFO("DATA for sequence number " << seq);
+  }
+
+  int hopCount = 0;
+  auto hopCountTag = data->getTag<lp::HopCountTag>();
+  if (hopCountTag != nullptr) { // e.g., packet came from local node's cache
+    hopCount = *hopCountTag;
+  }
+
+  SeqTimeoutsContainer::iterator entry = m_seqLastDelay.find(seq);
+  if (entry != m_seqLastDelay.end()) {
+    m_lastRetransmittedInterestDataDelay(this, seq, Simulator::Now() - entry->time, hopCount);
+  }
+
+  entry = m_seqFullDelay.find(seq);
+  if (entry != m_seqFullDelay.end()) {
+    m_firstInterestDataDelay(this, seq, Simulator::Now() - entry->time, m_seqRetxCounts[seq], hopCount);
+  }
+
+  m_seqRetxCounts.erase(seq);
+  m_seqFullDelay.erase(seq);
+  m_seqLastDelay.erase(seq);
+
+  m_seqTimeouts.erase(seq);
+  m_retxSeqs.erase(seq);
+
+  m_rtt->AckSeq(SequenceNumber32(seq));
+}
+
+void
+Supernode::OnNack(shared_ptr<const lp::Nack> nack)
+{
+  App::OnNack(nack);
+
+  // only IIM/SNCI come from this app, service requests are routed by ServiceStrategy
+  NS_LOG_DEBUG(nack->getInterest().getName() << " Nacked: " << nack->getReason());
+}
+
+void
+Supernode::StartApplication() // Called at time specified by Start
+{
+  NS_LOG_FUNCTION_NOARGS();
+
+  // do base stuff
+  App::StartApplication();
+
+  ScheduleNextPacket();
+}
+
+} // namespace ndn
+} // namespace ns3
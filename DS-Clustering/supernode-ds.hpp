@@ -1,96 +1,245 @@
-/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
-/**
- * Copyright (c) 2011-2015  Regents of the University of California.
- *
- * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
- * contributors.
- *
- * ndnSIM is free software: you can redistribute it and/or modify it under the terms
- * of the GNU General Public License as published by the Free Software Foundation,
- * either version 3 of the License, or (at your option) any later version.
- *
- * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
- * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
- * PURPOSE.  See the GNU General Public License for more details.
- *
- * You should have received a copy of the GNU General Public License along with
- * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
- **/
-
-#ifndef SUPERNODE
-#define SUPERNODE
-
-#include "ns3/ndnSIM/model/ndn-common.hpp"
-#include "ns3/ndnSIM/ndn-cxx/bloom_filter.hpp"
-
-#include "ndn-consumer.hpp"
-
-namespace ns3 {
-namespace ndn {
-
-/**
- * @ingroup ndn-apps
- * @brief Ndn application for sending out Interest packets at a "constant" rate (Poisson process)
- */
-class Supernode : public Consumer {
-public:
-  static TypeId
-  GetTypeId();
-
-  /**
-   * \brief Default constructor
-   * Sets up randomizer function and packet sequence number
-   */
-  Supernode();
-  virtual ~Supernode();
-
-protected:
-  /**
-   * \brief Constructs the Interest packet and sends it using a callback to the underlying NDN
-   * protocol
-   */
-  virtual void
-  ScheduleNextPacket();
-
-  /**
-   * @brief Actually send packet
-   */
-  void
-  SendPacket();
-
-  /**
-   * @brief Set type of frequency randomization
-   * @param value Either 'none', 'uniform', or 'exponential'
-   */
-  void
-  SetRandomize(const std::string& value);
-
-  /**
-   * @brief Get type of frequency randomization
-   * @returns either 'none', 'uniform', or 'exponential'
-   */
-  std::string
-  GetRandomize() const;
-
-  // From App
-  virtual void
-  OnData(shared_ptr<const Data> contentObject);
-
-  virtual void
-  OnNack(shared_ptr<const lp::Nack> nack);
-
-  virtual void
-  StartApplication();
-
-protected:
-  double m_frequency; // Frequency of interest packets (in hertz)
-  bool m_firstTime;
-  Ptr<RandomVariableStream> m_random;
-  std::string m_randomType;
-  bloom_filter domainFilter;
-};
-
-} // namespace ndn
-} // namespace ns3
-
-#endif
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef SUPERNODE
+#define SUPERNODE
+
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+#include "ns3/ndnSIM/ndn-cxx/bloom_filter.hpp"
+
+#include "ndn-consumer.hpp"
+#include "member-filter-table.hpp"
+#include "sharded-filter.hpp"
+
+#include "ns3/traced-callback.h"
+
+#include <map>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @ingroup ndn-apps
+ * @brief Ndn application for sending out Interest packets at a "constant" rate (Poisson process)
+ */
+class Supernode : public Consumer {
+public:
+  static TypeId
+  GetTypeId();
+
+  /**
+   * \brief Default constructor
+   * Sets up randomizer function and packet sequence number
+   */
+  Supernode();
+  virtual ~Supernode();
+
+  typedef void (*FilterChangedCallback)(uint32_t nodeId, uint64_t elementCount);
+
+  /**
+   * \brief Stop sending periodic packets, the domain filter is kept
+   */
+  void
+  Quiesce();
+
+  const bloom_filter&
+  GetDomainFilter() const;
+
+  /**
+   * \brief Replace the domain filter, e.g. when warm-starting from a snapshot
+   */
+  void
+  SetDomainFilter(const bloom_filter& filter);
+
+  /**
+   * \brief Store the level aggregate a level-`level` supernode of this node's overlay domain
+   * reported
+   */
+  void
+  SetChildFilter(uint32_t level, uint32_t nodeId, const bloom_filter& filter);
+
+  /**
+   * \brief Aggregate of this node's domain at level: domainFilter at level 1, above that the
+   * OR of this node's and its children's level - 1 aggregates, folded once
+   */
+  bloom_filter
+  GetLevelFilter(uint32_t level) const;
+
+  /**
+   * \brief OR a filter into domainFilter, e.g. the one of the supernode this node takes over from
+   */
+  void
+  MergeFilter(const bloom_filter& filter);
+
+  /**
+   * \brief Take a member's IIM reply: with MemberRounds set it replaces the member's previous
+   * filter in the member table, else it is ORed into domainFilter
+   */
+  void
+  MergeMemberFilter(uint32_t memberId, const bloom_filter& filter);
+
+  /**
+   * \brief Drop a member's filter from the member table, e.g. when it is gone
+   */
+  void
+  RemoveMember(uint32_t memberId);
+
+  /**
+   * \brief Filters merged into domainFilter so far, for the supernode load
+   */
+  uint64_t
+  GetMergeCount() const;
+
+  /**
+   * \brief Whether the IIM rounds still have filter upkeep to do: epoch rollover, member
+   *        expiry or a rebuild in progress, which Quiesce would freeze
+   */
+  bool
+  HasUpkeep() const;
+
+  /**
+   * \brief Restart the IIM after Quiesce, when the node becomes a supernode again
+   */
+  void
+  Resume();
+
+  /**
+   * \brief Keep a warm copy of the domain filter of a supernode this node backs up
+   */
+  void
+  SetBackupFilter(uint32_t supernodeId, const bloom_filter& filter);
+
+  /**
+   * \brief Merge the warm copy of a failed supernode into domainFilter
+   */
+  void
+  TakeOver(uint32_t supernodeId);
+
+  /**
+   * \brief Start domainFilter over: the filters merged during the next IIM period fill a
+   * fresh table, which then replaces it, dropping the bits of members that have left
+   *
+   * The shape cannot grow, the members' filters have to fit into it, so a noisy filter is
+   * made sparser by forgetting rather than by resizing. With EpochPeriods set the filter
+   * also forgets on its own, at every epoch rollover. With MemberRounds set it is recomputed
+   * at once from the members that replied during the last period instead.
+   */
+  void
+  Rebuild();
+
+  /**
+   * \brief OR a member's service filter into a shard of the sharded domain filter
+   */
+  void
+  MergeShard(uint32_t shard, const bloom_filter& filter);
+
+  const ShardedFilter&
+  GetShards() const;
+
+protected:
+  /**
+   * \brief Constructs the Interest packet and sends it using a callback to the underlying NDN
+   * protocol
+   */
+  virtual void
+  ScheduleNextPacket();
+
+  /**
+   * @brief Actually send packet
+   */
+  void
+  SendPacket();
+
+  /**
+   * @brief Send an IIM segment: one shard of the sharded domain filter, with its capacity
+   */
+  void
+  SendSegment(uint32_t shard);
+
+  /**
+   * @brief domainFilter from the member table and the filters from elsewhere
+   */
+  void
+  RecomputeDomainFilter();
+
+  /**
+   * @brief Set type of frequency randomization
+   * @param value Either 'none', 'uniform', or 'exponential'
+   */
+  void
+  SetRandomize(const std::string& value);
+
+  /**
+   * @brief Get type of frequency randomization
+   * @returns either 'none', 'uniform', or 'exponential'
+   */
+  std::string
+  GetRandomize() const;
+
+  // From App
+  virtual void
+  OnData(shared_ptr<const Data> contentObject);
+
+  virtual void
+  OnNack(shared_ptr<const lp::Nack> nack);
+
+  virtual void
+  StartApplication();
+
+protected:
+  double m_frequency; // Frequency of interest packets (in hertz)
+  bool m_firstTime;
+  Ptr<RandomVariableStream> m_random;
+  std::string m_randomType;
+  bloom_filter domainFilter;
+  bool m_quiesced;
+  std::map<uint32_t, std::map<uint32_t, bloom_filter>> m_childFilters; // by level and node id
+  std::map<uint32_t, bloom_filter> m_backupFilters; // by backed up supernode
+  uint64_t m_merges;
+  bool m_rebuilding;
+  Time m_rebuildStart;
+  bloom_filter m_rebuildFilter;
+  uint64_t m_rebuildMerges;
+  ShardedFilter m_shards;
+  uint32_t m_segmentRefresh; // IIM periods until all segments are sent again
+
+  // domainFilter is the OR of the previous and the current epoch, the current one is kept
+  // apart to become the whole filter at the next rollover
+  uint32_t m_epochPeriods; // IIM periods per epoch, 0 for no epochs
+  uint32_t m_epochAge;     // IIM periods into the current epoch
+  bloom_filter m_epochFilter;
+
+  // with MemberRounds, domainFilter is the member table's aggregate ORed with the filters that
+  // did not come from members (warm start, take-overs, MergeFilter). Those age like epochs of
+  // MemberRounds periods: m_otherFilter holds the previous and the current epoch, m_otherRecent
+  // only the current one
+  uint32_t m_memberRounds; // IIM periods a member's filter is kept, 0 for no member table
+  MemberFilterTable m_memberFilters;
+  bloom_filter m_otherFilter;
+  uint32_t m_otherAge; // IIM periods into the current epoch of m_otherRecent
+  bloom_filter m_otherRecent;
+
+  /// @brief Fired when a received filter added bits to domainFilter
+  TracedCallback<uint32_t, uint64_t> m_filterChanged;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif
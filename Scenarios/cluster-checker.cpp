@@ -0,0 +1,285 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "cluster-checker.hpp"
+
+#include <algorithm>
+#include <ostream>
+
+namespace ns3 {
+namespace ndn {
+
+namespace {
+
+const uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+/**
+ * Union-find with union by size and path halving
+ */
+class DisjointSets {
+public:
+  explicit DisjointSets(uint32_t n)
+    : m_parent(n)
+    , m_size(n, 1)
+  {
+    for (uint32_t i = 0; i < n; i++)
+      m_parent[i] = i;
+  }
+
+  uint32_t
+  Find(uint32_t x)
+  {
+    while (m_parent[x] != x) {
+      m_parent[x] = m_parent[m_parent[x]];
+      x = m_parent[x];
+    }
+    return x;
+  }
+
+  void
+  Union(uint32_t a, uint32_t b)
+  {
+    a = Find(a);
+    b = Find(b);
+    if (a == b)
+      return;
+    if (m_size[a] < m_size[b])
+      std::swap(a, b);
+    m_parent[b] = a;
+    m_size[a] += m_size[b];
+  }
+
+private:
+  std::vector<uint32_t> m_parent;
+  std::vector<uint32_t> m_size;
+};
+
+uint32_t
+Percentile(const std::vector<uint32_t>& sorted, uint32_t p)
+{
+  if (sorted.empty())
+    return 0;
+  size_t rank = (p * sorted.size() + 99) / 100;
+  return sorted[std::min(std::max<size_t>(rank, 1), sorted.size()) - 1];
+}
+
+} // namespace
+
+ClusterReport
+ClusterChecker::Check(const ClusterGraph& graph, const std::vector<uint8_t>& roles,
+                      const std::vector<uint32_t>& domains, uint32_t k)
+{
+  uint32_t n = graph.GetNNodes();
+
+  ClusterReport report;
+  report.nodes = n;
+  report.supernodes = 0;
+  report.backbone = 0;
+  report.components = 0;
+  report.k = k;
+  report.maxHops = 0;
+  report.meanHops = 0.0;
+
+  // domination: multi-source BFS from all supernodes, every node must be within k hops
+  std::vector<uint32_t> hops(n, NONE);
+  std::vector<uint32_t> queue;
+  queue.reserve(n);
+  for (uint32_t v = 0; v < n; v++) {
+    if (roles[v] == SUPERNODE) {
+      report.supernodes++;
+      hops[v] = 0;
+      queue.push_back(v);
+    }
+  }
+  for (size_t head = 0; head < queue.size(); head++) {
+    uint32_t v = queue[head];
+    for (const uint32_t* u = graph.begin(v); u != graph.end(v); u++) {
+      if (hops[*u] == NONE) {
+        hops[*u] = hops[v] + 1;
+        queue.push_back(*u);
+      }
+    }
+  }
+
+  uint64_t totalHops = 0;
+  uint32_t members = 0;
+  for (uint32_t v = 0; v < n; v++) {
+    if (hops[v] > k)
+      report.undominated.push_back(v);
+    if (hops[v] == NONE || hops[v] == 0)
+      continue;
+    members++;
+    totalHops += hops[v];
+    report.maxHops = std::max(report.maxHops, hops[v]);
+  }
+  if (members > 0)
+    report.meanHops = static_cast<double>(totalHops) / members;
+
+  // backbone connectivity
+  DisjointSets sets(n);
+  for (uint32_t v = 0; v < n; v++) {
+    if (roles[v] == MEMBER)
+      continue;
+    report.backbone++;
+    for (const uint32_t* u = graph.begin(v); u != graph.end(v); u++) {
+      if (*u > v && roles[*u] != MEMBER)
+        sets.Union(v, *u);
+    }
+  }
+  for (uint32_t v = 0; v < n; v++) {
+    if (roles[v] != MEMBER && sets.Find(v) == v)
+      report.components++;
+  }
+
+  // domain sizes, counting-sorted since they are bounded by n
+  if (!domains.empty()) {
+    std::vector<uint32_t> size(n, 0);
+    for (uint32_t v = 0; v < n; v++) {
+      if (roles[v] == SUPERNODE)
+        size[v]++;
+      else if (domains[v] < n && roles[domains[v]] == SUPERNODE)
+        size[domains[v]]++;
+      else
+        report.unassigned.push_back(v);
+    }
+
+    std::vector<uint32_t> histogram(n + 1, 0);
+    for (uint32_t v = 0; v < n; v++) {
+      if (roles[v] == SUPERNODE)
+        histogram[size[v]]++;
+    }
+    report.domainSizes.reserve(report.supernodes);
+    for (uint32_t s = 0; s <= n; s++)
+      report.domainSizes.insert(report.domainSizes.end(), histogram[s], s);
+  }
+
+  report.greedy = GreedyDominatingSet(graph);
+
+  return report;
+}
+
+uint32_t
+ClusterChecker::GreedyDominatingSet(const ClusterGraph& graph)
+{
+  uint32_t n = graph.GetNNodes();
+  if (n == 0)
+    return 0;
+
+  // gain[v]: uncovered nodes in the closed neighbourhood of v; nodes are kept in doubly
+  // linked buckets per gain, and every covered node decrements the gain of its closed
+  // neighbourhood once, so the whole run is O(V+E)
+  std::vector<uint32_t> gain(n);
+  std::vector<uint32_t> next(n, NONE);
+  std::vector<uint32_t> prev(n, NONE);
+  uint32_t maxGain = 0;
+  for (uint32_t v = 0; v < n; v++) {
+    gain[v] = graph.GetDegree(v) + 1;
+    maxGain = std::max(maxGain, gain[v]);
+  }
+
+  std::vector<uint32_t> head(maxGain + 1, NONE);
+  auto insert = [&](uint32_t v) {
+    prev[v] = NONE;
+    next[v] = head[gain[v]];
+    if (next[v] != NONE)
+      prev[next[v]] = v;
+    head[gain[v]] = v;
+  };
+  auto remove = [&](uint32_t v) {
+    if (prev[v] != NONE)
+      next[prev[v]] = next[v];
+    else
+      head[gain[v]] = next[v];
+    if (next[v] != NONE)
+      prev[next[v]] = prev[v];
+  };
+
+  for (uint32_t v = 0; v < n; v++)
+    insert(v);
+
+  std::vector<bool> covered(n, false);
+  std::vector<bool> chosen(n, false);
+  uint32_t uncovered = n;
+  uint32_t size = 0;
+
+  auto cover = [&](uint32_t u) {
+    if (covered[u])
+      return;
+    covered[u] = true;
+    uncovered--;
+
+    auto decrement = [&](uint32_t w) {
+      if (chosen[w])
+        return;
+      remove(w);
+      gain[w]--;
+      insert(w);
+    };
+    decrement(u);
+    for (const uint32_t* w = graph.begin(u); w != graph.end(u); w++)
+      decrement(*w);
+  };
+
+  while (uncovered > 0) {
+    while (head[maxGain] == NONE)
+      maxGain--;
+
+    uint32_t v = head[maxGain];
+    remove(v);
+    chosen[v] = true;
+    size++;
+
+    cover(v);
+    for (const uint32_t* u = graph.begin(v); u != graph.end(v); u++)
+      cover(*u);
+  }
+
+  return size;
+}
+
+void
+ClusterReport::Print(std::ostream& os) const
+{
+  os << "Nodes:           " << nodes << "\n"
+     << "Supernodes:      " << supernodes << "\n"
+     << "Backbone:        " << backbone << " nodes in " << components << " component(s)\n"
+     << "Undominated:     " << undominated.size();
+  for (size_t i = 0; i < undominated.size() && i < 10; i++)
+    os << (i == 0 ? " (" : ", ") << undominated[i];
+  if (!undominated.empty())
+    os << (undominated.size() > 10 ? ", ...)" : ")");
+  os << "\n";
+
+  if (!domainSizes.empty()) {
+    uint64_t total = 0;
+    for (uint32_t s : domainSizes)
+      total += s;
+    os << "Unassigned:      " << unassigned.size() << "\n"
+       << "Domain size:     min " << domainSizes.front() << ", p50 " << Percentile(domainSizes, 50)
+       << ", p90 " << Percentile(domainSizes, 90) << ", max " << domainSizes.back() << ", mean "
+       << static_cast<double>(total) / domainSizes.size() << "\n";
+  }
+
+  os << "Member hops:     mean " << meanHops << ", max " << maxHops << " (k = " << k << ")\n";
+
+  os << "Greedy DS:       " << greedy << " (ratio " << GetGreedyRatio() << ")\n";
+}
+
+} // namespace ndn
+} // namespace ns3
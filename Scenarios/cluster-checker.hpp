@@ -0,0 +1,117 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef CLUSTERCHECKER
+#define CLUSTERCHECKER
+
+#include "cluster-graph.hpp"
+
+#include <iosfwd>
+#include <limits>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief Result of ClusterChecker::Check
+ */
+struct ClusterReport
+{
+  static const uint32_t NO_DOMAIN = std::numeric_limits<uint32_t>::max();
+
+  uint32_t nodes;
+  uint32_t supernodes;
+  uint32_t backbone;   ///< supernodes plus connector nodes
+  uint32_t components; ///< connected components of the backbone
+
+  uint32_t k; ///< hops allowed between a member and the DS
+
+  std::vector<uint32_t> undominated; ///< nodes more than k hops away from the DS
+  std::vector<uint32_t> unassigned;  ///< members that never joined a domain
+
+  /// sorted domain sizes (supernode plus its members), one entry per supernode
+  std::vector<uint32_t> domainSizes;
+
+  /// hops from members to the nearest supernode, a proxy for intra-domain latency
+  uint32_t maxHops;
+  double meanHops;
+
+  uint32_t greedy; ///< size of a greedy (1-hop) dominating set of the same graph
+
+  bool
+  IsDominatingSet() const
+  {
+    return undominated.empty();
+  }
+
+  bool
+  IsConnected() const
+  {
+    return components <= 1;
+  }
+
+  double
+  GetGreedyRatio() const
+  {
+    return greedy == 0 ? 0.0 : static_cast<double>(supernodes) / greedy;
+  }
+
+  void
+  Print(std::ostream& os) const;
+};
+
+/**
+ * @brief O(V+E) validity and quality check of a DS/CDS clustering
+ *
+ * Verifies that the supernodes (k-)dominate the graph, counts the connected components of the
+ * backbone with union-find, collects the domain size distribution and compares the number
+ * of supernodes with the centralised greedy dominating set (computed with a bucket queue,
+ * so also in linear time).
+ */
+class ClusterChecker {
+public:
+  enum Role {
+    MEMBER = 0,
+    SUPERNODE = 1,
+    CONNECTOR = 2
+  };
+
+  /**
+   * @param graph   topology
+   * @param roles   Role of every node
+   * @param domains supernode id chosen by every member, ClusterReport::NO_DOMAIN if unknown;
+   *                may be empty, in which case no domain sizes are reported
+   * @param k       hops allowed between a member and the nearest supernode (k-hop mode)
+   */
+  static ClusterReport
+  Check(const ClusterGraph& graph, const std::vector<uint8_t>& roles,
+        const std::vector<uint32_t>& domains, uint32_t k = 1);
+
+  /**
+   * @brief Size of the dominating set picked by the classic greedy algorithm
+   */
+  static uint32_t
+  GreedyDominatingSet(const ClusterGraph& graph);
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif
@@ -0,0 +1,87 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "cluster-graph.hpp"
+#include "ns3/node-list.h"
+#include "ns3/node.h"
+#include "ns3/net-device.h"
+#include "ns3/channel.h"
+
+#include <algorithm>
+
+namespace ns3 {
+namespace ndn {
+
+ClusterGraph
+ClusterGraph::WithoutNode(uint32_t node) const
+{
+  ClusterGraph graph;
+  graph.offsets.reserve(offsets.size());
+  graph.targets.reserve(targets.size());
+  graph.offsets.push_back(0);
+
+  for (uint32_t v = 0; v < GetNNodes(); v++) {
+    if (v != node) {
+      for (const uint32_t* u = begin(v); u != end(v); u++) {
+        if (*u != node)
+          graph.targets.push_back(*u);
+      }
+    }
+    graph.offsets.push_back(graph.targets.size());
+  }
+
+  return graph;
+}
+
+ClusterGraph
+ClusterGraph::FromNodeList()
+{
+  ClusterGraph graph;
+  uint32_t nNodes = NodeList::GetNNodes();
+  graph.offsets.reserve(nNodes + 1);
+  graph.offsets.push_back(0);
+
+  for (uint32_t id = 0; id < nNodes; id++) {
+    Ptr<Node> node = NodeList::GetNode(id);
+    size_t first = graph.targets.size();
+
+    for (uint32_t d = 0; d < node->GetNDevices(); d++) {
+      Ptr<Channel> channel = node->GetDevice(d)->GetChannel();
+      if (channel == 0)
+        continue;
+
+      for (uint32_t c = 0; c < channel->GetNDevices(); c++) {
+        uint32_t other = channel->GetDevice(c)->GetNode()->GetId();
+        if (other != id)
+          graph.targets.push_back(other);
+      }
+    }
+
+    // parallel links count once
+    std::sort(graph.targets.begin() + first, graph.targets.end());
+    graph.targets.erase(std::unique(graph.targets.begin() + first, graph.targets.end()),
+                        graph.targets.end());
+    graph.offsets.push_back(graph.targets.size());
+  }
+
+  return graph;
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,102 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef CLUSTERGRAPH
+#define CLUSTERGRAPH
+
+#include <cstdint>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief Undirected node adjacency in compressed sparse row form
+ *
+ * The neighbours of node v are targets[offsets[v]] .. targets[offsets[v + 1] - 1], sorted
+ * and without duplicates. Node ids are ns-3 node ids.
+ */
+struct ClusterGraph
+{
+  std::vector<uint32_t> offsets;
+  std::vector<uint32_t> targets;
+
+  uint32_t
+  GetNNodes() const
+  {
+    return offsets.empty() ? 0 : offsets.size() - 1;
+  }
+
+  uint32_t
+  GetDegree(uint32_t node) const
+  {
+    return offsets[node + 1] - offsets[node];
+  }
+
+  const uint32_t*
+  begin(uint32_t node) const
+  {
+    return targets.data() + offsets[node];
+  }
+
+  const uint32_t*
+  end(uint32_t node) const
+  {
+    return targets.data() + offsets[node + 1];
+  }
+
+  /**
+   * @brief FNV-1a hash of the adjacency, identifies the topology e.g. for snapshots
+   */
+  uint64_t
+  GetHash() const
+  {
+    uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](uint32_t value) {
+      for (int i = 0; i < 4; i++) {
+        hash ^= (value >> (8 * i)) & 0xff;
+        hash *= 1099511628211ULL;
+      }
+    };
+
+    mix(GetNNodes());
+    for (uint32_t offset : offsets)
+      mix(offset);
+    for (uint32_t target : targets)
+      mix(target);
+    return hash;
+  }
+
+  /**
+   * @brief The same graph with all links of node removed, e.g. after it failed
+   */
+  ClusterGraph
+  WithoutNode(uint32_t node) const;
+
+  /**
+   * @brief Build the adjacency of all nodes in the ns-3 NodeList from their channels
+   */
+  static ClusterGraph
+  FromNodeList();
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif
@@ -0,0 +1,546 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/point-to-point-layout-module.h"
+#include "ns3/ndnSIM-module.h"
+
+#include "convergence-detector.hpp"
+#include "cluster-checker.hpp"
+#include "mmap-topology-reader.hpp"
+#include "service-resolution-tracer.hpp"
+
+#include "ns3/ndnSIM/apps/cluster-snapshot.hpp"
+#include "ns3/ndnSIM/apps/service-strategy.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <string>
+
+namespace ns3 {
+
+/**
+ * Clustering scenario used by Tools/sweep-runner.
+ *
+ * Installs Clusterconsumer and Clusterproducer on every node of an annotated topology file,
+ * a binary CSR topology (--topology-bin, see Tools/topology-convert) or a grid, runs the
+ * simulation and prints a single METRICS line:
+ *
+ *     METRICS supernodes=12 convergence=3.2 converged=1 interests=4711 datas=4242 nodes=100
+ *
+ * followed by the handovers and the smallest and largest domain (min_domain=, max_domain=,
+ * members that sent their supernode an SCI within MissedRounds periods).
+ *
+ * App attributes (Frequency, Randomize, ...) are set on the command line through the
+ * usual ns-3 syntax, e.g. --ns3::ndn::Clusterconsumer::Frequency=0.5, and the seed
+ * through --RngRun. The convergence time comes from ConvergenceDetector, whose Window and
+ * Action are set the same way (--ns3::ndn::ConvergenceDetector::Action=stop ends the run
+ * as soon as the clustering has settled).
+ *
+ * With --check=ds or --check=cds the final clustering is verified by ClusterChecker, its
+ * report is printed to stderr and the scenario exits with status 1 if the supernodes do
+ * not dominate the graph (or, for cds, the backbone is not connected), so the scenario
+ * doubles as a regression test.
+ *
+ * --fail-node cuts every link of a node at --fail-time, as if it crashed, to measure the
+ * local repair: the METRICS line then adds the number of repair rounds and the time from
+ * the failure to the last of them, and --check verifies the graph without the failed node.
+ *
+ * --save-snapshot writes the final roles, supernode faces and domain filters to a file;
+ * --load-snapshot starts every node from such a file (taken on the same topology) instead
+ * of running the election, e.g. for service-routing experiments.
+ *
+ * --providers places that many ndn::Producer apps on random nodes, serving /service/0 ..
+ * /service/<services - 1>, and --requesters as many ConsumerCbr apps requesting one of them
+ * from --request-start on. Service requests are forwarded by ServiceStrategy, and the METRICS
+ * line adds the resolved requests, their mean path stretch and latency relative to flooding
+ * (ServiceResolutionTracer) and the number of floods and hedges (--hedge-k, --hedge-delay).
+ * With --cache-size above 0 supernodes cache resolutions for --cache-ttl, and METRICS adds
+ * the cache hit rate and the mean latency a hit saved. It also reports the share of requests
+ * sent on supernode filters that were false positives, and the filter rebuilds asked of noisy
+ * supernodes (--fp-threshold). --balance spreads requests over the matching providers
+ * (--retire), and METRICS adds the 99th percentile of the resolution latency and the providers
+ * retired as overloaded; --skew draws the requested services from a Zipf distribution.
+ * EpochPeriods of ns3::ndn::Supernode (SupernodeCDS for the CDS variant) lets the domain
+ * filters drop what the members stop advertising, MemberRounds of the same classes keeps one
+ * filter per member and recomputes the domain filter exactly when one leaves.
+ *
+ * With MaxLevel > 1 and FilterReach > 1 (--ns3::ndn::Clusterconsumer::FilterReach=3)
+ * supernodes pass their domain filters over the overlay, folded once per hop beyond the
+ * first; METRICS adds the filters and table bytes sent (distant_filters=, distant_bytes=)
+ * and, with a service workload, the requests sent to distant domains (distant=).
+ */
+class ClusteringMetrics {
+public:
+  ClusteringMetrics(Ptr<ndn::ConvergenceDetector> detector)
+    : m_detector(detector)
+    , m_interests(0)
+    , m_datas(0)
+    , m_domains(NodeList::GetNNodes(), ndn::ClusterReport::NO_DOMAIN)
+    , m_connectors(NodeList::GetNNodes(), false)
+    , m_checked(false)
+    , m_repairs(0)
+    , m_handovers(0)
+    , m_failTime(-1)
+    , m_lastRepair(0)
+    , m_distantFilters(0)
+    , m_distantBytes(0)
+  {
+  }
+
+  void
+  SetTracer(Ptr<ndn::ServiceResolutionTracer> tracer)
+  {
+    m_tracer = tracer;
+  }
+
+  void
+  Connect()
+  {
+    Config::ConnectWithoutContext("/NodeList/*/$ns3::ndn::L3Protocol/OutInterests",
+                                  MakeCallback(&ClusteringMetrics::OutInterest, this));
+    Config::ConnectWithoutContext("/NodeList/*/$ns3::ndn::L3Protocol/OutData",
+                                  MakeCallback(&ClusteringMetrics::OutData, this));
+    const std::string consumer = "/NodeList/*/ApplicationList/*/$ns3::ndn::Clusterconsumer/";
+    Config::ConnectWithoutContext(consumer + "SupernodeChanged",
+                                  MakeCallback(&ClusteringMetrics::SupernodeChanged, this));
+
+    Config::ConnectWithoutContext(consumer + "LevelChanged",
+                                  MakeCallback(&ClusteringMetrics::LevelChanged, this));
+    Config::ConnectWithoutContext(consumer + "Repair",
+                                  MakeCallback(&ClusteringMetrics::Repair, this));
+    Config::ConnectWithoutContext(consumer + "Handover",
+                                  MakeCallback(&ClusteringMetrics::Handover, this));
+    Config::ConnectWithoutContext(consumer + "DistantFilterSent",
+                                  MakeCallback(&ClusteringMetrics::DistantFilterSent, this));
+
+    // only the CDS variant selects connectors
+    TypeId consumerId = TypeId::LookupByName("ns3::ndn::Clusterconsumer");
+    if (consumerId.LookupTraceSourceByName("ConnectorChanged") != 0)
+      Config::ConnectWithoutContext(consumer + "ConnectorChanged",
+                                    MakeCallback(&ClusteringMetrics::ConnectorChanged, this));
+  }
+
+  /**
+   * @brief Cut every link of a node, as if it crashed
+   *
+   * Packets over its links are dropped at both ends. Point-to-point devices do not report
+   * carrier loss, so the nodes at both ends are told through Clusterconsumer::LinkChanged,
+   * as a link layer detecting it would.
+   */
+  void
+  FailNode(uint32_t nodeId)
+  {
+    m_failTime = Simulator::Now().ToDouble(Time::S);
+
+    Ptr<RateErrorModel> drop = CreateObject<RateErrorModel>();
+    drop->SetAttribute("ErrorRate", DoubleValue(1.0));
+    drop->SetAttribute("ErrorUnit", StringValue("ERROR_UNIT_PACKET"));
+
+    Ptr<Node> node = NodeList::GetNode(nodeId);
+    for (uint32_t d = 0; d < node->GetNDevices(); d++) {
+      Ptr<Channel> channel = node->GetDevice(d)->GetChannel();
+      if (channel == 0)
+        continue;
+
+      for (uint32_t c = 0; c < channel->GetNDevices(); c++) {
+        Ptr<NetDevice> device = channel->GetDevice(c);
+        device->SetAttributeFailSafe("ReceiveErrorModel", PointerValue(drop));
+        Ptr<ndn::Clusterconsumer> consumer =
+          ndn::Clusterconsumer::GetClusterconsumer(device->GetNode());
+        if (consumer != 0)
+          consumer->LinkChanged();
+      }
+    }
+  }
+
+  /**
+   * @returns false if the clustering is not a valid DS (or CDS, if requireConnected)
+   */
+  bool
+  Check(const ndn::ClusterGraph& graph, bool requireConnected)
+  {
+    std::vector<uint8_t> roles(NodeList::GetNNodes());
+    for (uint32_t i = 0; i < roles.size(); i++) {
+      if (IsSupernode(NodeList::GetNode(i)))
+        roles[i] = ndn::ClusterChecker::SUPERNODE;
+      else if (m_connectors[i])
+        roles[i] = ndn::ClusterChecker::CONNECTOR;
+      else
+        roles[i] = ndn::ClusterChecker::MEMBER;
+    }
+
+    // members may be up to K hops from their supernode in k-hop mode
+    UintegerValue k(1);
+    Ptr<ndn::Clusterconsumer> consumer =
+      ndn::Clusterconsumer::GetClusterconsumer(NodeList::GetNode(0));
+    if (consumer != 0)
+      consumer->GetAttribute("K", k);
+
+    m_report = ndn::ClusterChecker::Check(graph, roles, m_domains, k.Get());
+    m_checked = true;
+    m_report.Print(std::cerr);
+
+    return m_report.IsDominatingSet() && (!requireConnected || m_report.IsConnected());
+  }
+
+  void
+  Print(std::ostream& os) const
+  {
+    uint32_t supernodes = 0;
+    uint32_t minDomain = std::numeric_limits<uint32_t>::max();
+    uint32_t maxDomain = 0;
+    for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
+      if (!IsSupernode(*node))
+        continue;
+      supernodes++;
+      Ptr<ndn::Clusterconsumer> consumer = ndn::Clusterconsumer::GetClusterconsumer(*node);
+      uint32_t size = consumer != 0 ? consumer->GetDomainSize() : 0;
+      minDomain = std::min(minDomain, size);
+      maxDomain = std::max(maxDomain, size);
+    }
+
+    os << "METRICS"
+       << " supernodes=" << supernodes
+       << " convergence=" << m_detector->GetConvergenceTime().ToDouble(Time::S)
+       << " converged=" << m_detector->HasConverged()
+       << " interests=" << m_interests
+       << " datas=" << m_datas
+       << " nodes=" << NodeList::GetNNodes()
+       << " handovers=" << m_handovers
+       << " min_domain=" << (supernodes > 0 ? minDomain : 0)
+       << " max_domain=" << maxDomain;
+
+    // supernodes of the overlay levels above 1, if any
+    for (uint32_t level = 2; level < m_levels.size(); level++)
+      os << " level" << level << "=" << m_levels[level];
+
+    // domain filters passed beyond the adjacent domains, with FilterReach > 1
+    if (m_distantFilters > 0)
+      os << " distant_filters=" << m_distantFilters << " distant_bytes=" << m_distantBytes;
+
+    if (m_failTime >= 0) {
+      os << " repairs=" << m_repairs
+         << " repair_time=" << (m_repairs > 0 ? m_lastRepair - m_failTime : 0);
+    }
+
+    if (m_tracer != 0) {
+      os << " resolutions=" << m_tracer->GetResolutions()
+         << " stretch=" << m_tracer->GetMeanStretch()
+         << " latency_ratio=" << m_tracer->GetMeanLatencyRatio()
+         << " floods=" << m_tracer->GetDecisions(nfd::fw::ServiceStrategy::TO_ALL)
+         << " hedges=" << m_tracer->GetDecisions(nfd::fw::ServiceStrategy::HEDGE)
+         << " cache_hit_rate=" << m_tracer->GetCacheHitRate()
+         << " cache_saving=" << m_tracer->GetMeanCacheSaving().GetMilliSeconds()
+         << " fp_rate=" << m_tracer->GetFalsePositiveRate()
+         << " rebuilds=" << m_tracer->GetRebuilds()
+         << " p99_ms=" << m_tracer->GetLatencyPercentile(0.99).GetMilliSeconds()
+         << " retired=" << m_tracer->GetRetirements()
+         << " distant=" << m_tracer->GetDecisions(nfd::fw::ServiceStrategy::TO_DISTANT);
+    }
+
+    if (m_checked) {
+      os << " undominated=" << m_report.undominated.size()
+         << " components=" << m_report.components
+         << " greedy_ratio=" << m_report.GetGreedyRatio()
+         << " mean_hops=" << m_report.meanHops
+         << " max_hops=" << m_report.maxHops;
+    }
+    os << std::endl;
+  }
+
+private:
+  // a supernode that handed its role over keeps the mark of its Node
+  static bool
+  IsSupernode(Ptr<Node> node)
+  {
+    Ptr<ndn::Clusterconsumer> consumer = ndn::Clusterconsumer::GetClusterconsumer(node);
+    return consumer != 0 ? consumer->IsSupernode() : node->IsSupernode();
+  }
+
+  void
+  OutInterest(const ndn::Interest&, const ndn::Face&)
+  {
+    m_interests++;
+  }
+
+  void
+  OutData(const ndn::Data&, const ndn::Face&)
+  {
+    m_datas++;
+  }
+
+  void
+  SupernodeChanged(uint32_t nodeId, uint32_t supernodeId, uint32_t face)
+  {
+    m_domains[nodeId] = supernodeId;
+  }
+
+  void
+  LevelChanged(uint32_t nodeId, uint32_t level)
+  {
+    if (m_levels.size() <= level)
+      m_levels.resize(level + 1, 0);
+    m_levels[level]++;
+  }
+
+  void
+  Repair(uint32_t nodeId, uint32_t hops)
+  {
+    if (m_failTime < 0)
+      return; // only repairs of the injected failure are measured
+
+    m_repairs++;
+    m_lastRepair = Simulator::Now().ToDouble(Time::S);
+  }
+
+  void
+  Handover(uint32_t nodeId, uint32_t successorId, double load)
+  {
+    m_handovers++;
+  }
+
+  void
+  DistantFilterSent(uint32_t nodeId, uint32_t hops, uint32_t bytes)
+  {
+    m_distantFilters++;
+    m_distantBytes += bytes;
+  }
+
+  void
+  ConnectorChanged(uint32_t nodeId, bool isConnector)
+  {
+    m_connectors[nodeId] = isConnector;
+  }
+
+private:
+  Ptr<ndn::ConvergenceDetector> m_detector;
+  uint64_t m_interests;
+  uint64_t m_datas;
+  std::vector<uint32_t> m_domains;
+  std::vector<bool> m_connectors;
+  std::vector<uint32_t> m_levels; // supernodes per overlay level
+  ndn::ClusterReport m_report;
+  bool m_checked;
+  uint64_t m_repairs;   // repair rounds, all nodes
+  double m_failTime;    // -1 without --fail-node
+  double m_lastRepair;
+  uint64_t m_handovers; // supernode roles handed over under load
+  uint64_t m_distantFilters; // sent by supernodes, all overlay hops
+  uint64_t m_distantBytes;
+  Ptr<ndn::ServiceResolutionTracer> m_tracer; // with --providers
+};
+
+int
+main(int argc, char* argv[])
+{
+  std::string topology;
+  std::string topologyBin;
+  uint32_t rows = 10;
+  uint32_t cols = 10;
+  double stopTime = 60.0;
+  std::string check = "none";
+  std::string saveSnapshot;
+  std::string loadSnapshot;
+  int32_t failNode = -1;
+  double failTime = 30.0;
+  uint32_t providers = 0;
+  uint32_t services = 0;
+  uint32_t requesters = 0;
+  double requestRate = 1.0;
+  double requestStart = 30.0;
+  uint32_t hedgeK = 2;
+  uint32_t hedgeDelay = 0;
+  uint32_t cacheSize = 256;
+  uint32_t cacheTtl = 10000;
+  uint32_t fpThreshold = 20;
+  bool providerResources = false;
+  uint32_t balance = 0;
+  uint32_t retireTime = 1000;
+  double skew = 0.0;
+
+  CommandLine cmd;
+  cmd.AddValue("topology", "Annotated topology file (a rows x cols grid is used if empty)",
+               topology);
+  cmd.AddValue("topology-bin", "Binary CSR topology file, for very large topologies", topologyBin);
+  cmd.AddValue("rows", "Number of grid rows", rows);
+  cmd.AddValue("cols", "Number of grid columns", cols);
+  cmd.AddValue("stop", "Simulation stop time in seconds", stopTime);
+  cmd.AddValue("check", "Verify the final clustering: none, ds or cds", check);
+  cmd.AddValue("save-snapshot", "Save the final clustering state to this file", saveSnapshot);
+  cmd.AddValue("load-snapshot", "Warm-start from a clustering snapshot", loadSnapshot);
+  cmd.AddValue("fail-node", "Node whose links are all cut at fail-time (-1 for none)", failNode);
+  cmd.AddValue("fail-time", "Time of the node failure in seconds", failTime);
+  cmd.AddValue("providers", "Service providers placed on random nodes", providers);
+  cmd.AddValue("services", "Distinct services among the providers (0 for one each)", services);
+  cmd.AddValue("requesters", "Nodes requesting a random service", requesters);
+  cmd.AddValue("request-rate", "Requests per second of every requester", requestRate);
+  cmd.AddValue("request-start", "Time of the first requests in seconds", requestStart);
+  cmd.AddValue("hedge-k", "Candidate domains a request is sent to (0 for all)", hedgeK);
+  cmd.AddValue("hedge-delay", "Milliseconds before the candidates after the best are asked",
+               hedgeDelay);
+  cmd.AddValue("cache-size", "Resolution cache entries of a supernode (0 for none)", cacheSize);
+  cmd.AddValue("cache-ttl", "Milliseconds a cached resolution is used", cacheTtl);
+  cmd.AddValue("fp-threshold", "False positive percentage a filter is rebuilt at (0 never)",
+               fpThreshold);
+  cmd.AddValue("provider-resources", "Draw the Cpu and Ram of provider nodes from [0.5, 8)",
+               providerResources);
+  cmd.AddValue("balance",
+               "Requests in flight per provider before it is retired (0 for no balancing)",
+               balance);
+  cmd.AddValue("retire", "Milliseconds an overloaded provider is passed over", retireTime);
+  cmd.AddValue("skew", "Zipf exponent of the requested services (0 for uniform)", skew);
+  cmd.Parse(argc, argv);
+
+  ndn::ClusterGraph graph;
+  if (!topologyBin.empty()) {
+    ndn::MmapTopologyReader topologyReader(topologyBin);
+    if (topologyReader.Read().GetN() == 0)
+      return 1;
+    topologyReader.InstallClusterApps();
+    graph = topologyReader.GetGraph();
+  }
+  else {
+    NodeContainer nodes;
+    if (!topology.empty()) {
+      AnnotatedTopologyReader topologyReader("", 25);
+      topologyReader.SetFileName(topology);
+      nodes = topologyReader.Read();
+    }
+    else {
+      PointToPointHelper p2p;
+      p2p.SetChannelAttribute("Delay", StringValue("10ms"));
+      PointToPointGridHelper grid(rows, cols, p2p);
+      grid.BoundingBox(100, 100, 200, 200);
+      nodes = NodeContainer::GetGlobal();
+    }
+
+    ndn::StackHelper ndnHelper;
+    ndnHelper.InstallAll();
+
+    ndn::AppHelper consumerHelper("ns3::ndn::Clusterconsumer");
+    consumerHelper.SetPrefix("ndn:/localhop/Cluster");
+    consumerHelper.Install(nodes);
+
+    ndn::AppHelper producerHelper("ns3::ndn::Clusterproducer");
+    producerHelper.SetPrefix("/");
+    producerHelper.Install(nodes);
+
+    graph = ndn::ClusterGraph::FromNodeList();
+  }
+
+  ndn::StrategyChoiceHelper::InstallAll("/", "/localhost/nfd/strategy/multicast");
+
+  // connected before the warm start, whose role and face changes fill the domains
+  Ptr<ndn::ConvergenceDetector> detector = CreateObject<ndn::ConvergenceDetector>();
+  ClusteringMetrics metrics(detector);
+  metrics.Connect();
+
+  uint64_t topologyHash = graph.GetHash();
+  if (!loadSnapshot.empty()) {
+    if (ndn::ClusterSnapshot::Load(loadSnapshot, topologyHash))
+      detector->WarmStarted();
+    else
+      std::cerr << "Cannot warm-start from " << loadSnapshot << ", running the election"
+                << std::endl;
+  }
+  detector->Start();
+
+  if (providers > 0) {
+    ndn::Name strategy = nfd::fw::ServiceStrategy::getStrategyName();
+    strategy.append("k~" + std::to_string(hedgeK)).append("hedge~" + std::to_string(hedgeDelay));
+    strategy.append("cache~" + std::to_string(cacheSize)).append("ttl~" + std::to_string(cacheTtl));
+    strategy.append("fp~" + std::to_string(fpThreshold));
+    strategy.append("balance~" + std::to_string(balance));
+    strategy.append("retire~" + std::to_string(retireTime));
+    ndn::StrategyChoiceHelper::InstallAll("/service", strategy);
+
+    Ptr<ndn::ServiceResolutionTracer> tracer = CreateObject<ndn::ServiceResolutionTracer>();
+    Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable>();
+    uint32_t nNodes = NodeList::GetNNodes();
+    if (services == 0)
+      services = providers;
+
+    for (uint32_t i = 0; i < providers; i++) {
+      uint32_t nodeId = random->GetInteger(0, nNodes - 1);
+      ndn::Name service("/service/" + std::to_string(i % services));
+
+      ndn::AppHelper providerHelper("ns3::ndn::Producer");
+      providerHelper.SetPrefix(service.toUri());
+      providerHelper.Install(NodeList::GetNode(nodeId));
+      tracer->AddProvider(service, nodeId);
+
+      // the resource classes go into the domain filter with the name
+      Ptr<ndn::Clusterconsumer> consumer =
+        ndn::Clusterconsumer::GetClusterconsumer(NodeList::GetNode(nodeId));
+      if (consumer != 0) {
+        if (providerResources) {
+          consumer->SetAttribute("Cpu", DoubleValue(random->GetValue(0.5, 8.0)));
+          consumer->SetAttribute("Ram", DoubleValue(random->GetValue(0.5, 8.0)));
+        }
+        consumer->AdvertiseService(service);
+      }
+    }
+
+    Ptr<ZipfRandomVariable> zipf = CreateObject<ZipfRandomVariable>();
+    zipf->SetAttribute("N", IntegerValue(services));
+    zipf->SetAttribute("Alpha", DoubleValue(skew));
+    for (uint32_t i = 0; i < requesters; i++) {
+      uint32_t index = skew > 0.0 ? zipf->GetInteger() - 1 : random->GetInteger(0, services - 1);
+      ndn::Name service("/service/" + std::to_string(index));
+
+      ndn::AppHelper requesterHelper("ns3::ndn::ConsumerCbr");
+      requesterHelper.SetPrefix(service.toUri());
+      requesterHelper.SetAttribute("Frequency", DoubleValue(requestRate));
+      requesterHelper.Install(NodeList::GetNode(random->GetInteger(0, nNodes - 1)))
+        .Start(Seconds(requestStart));
+    }
+
+    tracer->Start(graph);
+    metrics.SetTracer(tracer);
+  }
+
+  if (failNode >= 0 && static_cast<uint32_t>(failNode) < NodeList::GetNNodes()) {
+    Simulator::Schedule(Seconds(failTime), &ClusteringMetrics::FailNode, &metrics, failNode);
+    graph = graph.WithoutNode(failNode);
+  }
+
+  Simulator::Stop(Seconds(stopTime));
+  Simulator::Run();
+
+  bool valid = check == "none" || metrics.Check(graph, check == "cds");
+  if (!saveSnapshot.empty() && !ndn::ClusterSnapshot::Save(saveSnapshot, topologyHash))
+    std::cerr << "Cannot save snapshot " << saveSnapshot << std::endl;
+  metrics.Print(std::cout);
+
+  Simulator::Destroy();
+
+  return valid ? 0 : 1;
+}
+
+} // namespace ns3
+
+int
+main(int argc, char* argv[])
+{
+  return ns3::main(argc, argv);
+}
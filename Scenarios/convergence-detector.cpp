@@ -0,0 +1,216 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "convergence-detector.hpp"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/node-list.h"
+#include "ns3/callback.h"
+
+#include "ns3/ndnSIM/apps/clusterc.hpp"
+
+#include <vector>
+
+NS_LOG_COMPONENT_DEFINE("ConvergenceDetector");
+
+namespace ns3 {
+namespace ndn {
+
+NS_OBJECT_ENSURE_REGISTERED(ConvergenceDetector);
+
+TypeId
+ConvergenceDetector::GetTypeId(void)
+{
+  static TypeId tid =
+    TypeId("ns3::ndn::ConvergenceDetector")
+      .SetGroupName("Ndn")
+      .SetParent<Object>()
+      .AddConstructor<ConvergenceDetector>()
+
+      .AddAttribute("Window", "Time without role, face or filter changes before declaring convergence",
+                    TimeValue(Seconds(10.0)), MakeTimeAccessor(&ConvergenceDetector::m_window),
+                    MakeTimeChecker())
+
+      .AddAttribute("CheckInterval", "Interval between two stabilisation checks",
+                    TimeValue(Seconds(1.0)), MakeTimeAccessor(&ConvergenceDetector::m_checkInterval),
+                    MakeTimeChecker())
+
+      .AddAttribute("Action", "What to do on convergence: none, quiesce (default) or stop",
+                    StringValue("quiesce"), MakeStringAccessor(&ConvergenceDetector::m_action),
+                    MakeStringChecker())
+
+      .AddTraceSource("Converged", "Clustering converged, with the time of the last change",
+                      MakeTraceSourceAccessor(&ConvergenceDetector::m_convergedTrace),
+                      "ns3::ndn::ConvergenceDetector::ConvergedCallback")
+
+    ;
+
+  return tid;
+}
+
+ConvergenceDetector::ConvergenceDetector()
+  : m_changes(0)
+  , m_converged(false)
+{
+}
+
+void
+ConvergenceDetector::Start()
+{
+  NS_LOG_FUNCTION_NOARGS();
+
+  ConnectApplications();
+  m_checkEvent = Simulator::Schedule(m_checkInterval, &ConvergenceDetector::Check, this);
+}
+
+void
+ConvergenceDetector::WarmStarted()
+{
+  NS_LOG_FUNCTION_NOARGS();
+
+  Changed();
+}
+
+bool
+ConvergenceDetector::HasConverged() const
+{
+  return m_converged;
+}
+
+Time
+ConvergenceDetector::GetConvergenceTime() const
+{
+  return m_convergenceTime;
+}
+
+void
+ConvergenceDetector::ConnectApplications()
+{
+  for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
+    for (uint32_t i = 0; i < (*node)->GetNApplications(); i++) {
+      Ptr<Application> app = (*node)->GetApplication(i);
+      if (!m_connected.insert(app).second)
+        continue;
+
+      // apps without the trace source simply refuse the connection
+      app->TraceConnectWithoutContext("RoleChanged",
+                                      MakeCallback(&ConvergenceDetector::RoleChanged, this));
+      app->TraceConnectWithoutContext("SupernodeChanged",
+                                      MakeCallback(&ConvergenceDetector::SupernodeChanged, this));
+      app->TraceConnectWithoutContext("FilterChanged",
+                                      MakeCallback(&ConvergenceDetector::FilterChanged, this));
+      app->TraceConnectWithoutContext("ConnectorChanged",
+                                      MakeCallback(&ConvergenceDetector::ConnectorChanged, this));
+      app->TraceConnectWithoutContext("LevelChanged",
+                                      MakeCallback(&ConvergenceDetector::LevelChanged, this));
+    }
+  }
+}
+
+void
+ConvergenceDetector::Check()
+{
+  // supernode apps created since the last check may already have merged filters, which
+  // counts as a change
+  size_t connected = m_connected.size();
+  ConnectApplications();
+  if (m_connected.size() != connected)
+    Changed();
+
+  if (m_changes == 0 || Simulator::Now() - m_lastChange < m_window) {
+    m_checkEvent = Simulator::Schedule(m_checkInterval, &ConvergenceDetector::Check, this);
+    return;
+  }
+
+  // later changes (rebuilds, handovers, expiry) no longer move the convergence time
+  m_converged = true;
+  m_convergenceTime = m_lastChange;
+  NS_LOG_INFO("Clustering converged at " << m_convergenceTime.ToDouble(Time::S) << "s after "
+              << m_changes << " changes");
+  m_convergedTrace(m_convergenceTime);
+
+  if (m_action == "quiesce") {
+    std::vector<Ptr<Clusterconsumer>> consumers;
+    bool canQuiesce = true;
+    for (NodeList::Iterator node = NodeList::Begin(); node != NodeList::End(); node++) {
+      Ptr<Clusterconsumer> consumer = Clusterconsumer::GetClusterconsumer(*node);
+      if (consumer != 0) {
+        consumers.push_back(consumer);
+        canQuiesce = canQuiesce && consumer->CanQuiesce();
+      }
+    }
+
+    if (!canQuiesce) {
+      NS_LOG_WARN("Not quiescing: service filters, epochs, member expiry or a rebuild still "
+                  "run on the periodic rounds");
+      return;
+    }
+    for (Ptr<Clusterconsumer> consumer : consumers)
+      consumer->Quiesce();
+  }
+  else if (m_action == "stop") {
+    Simulator::Stop();
+  }
+}
+
+void
+ConvergenceDetector::Changed()
+{
+  m_changes++;
+  m_lastChange = Simulator::Now();
+}
+
+void
+ConvergenceDetector::RoleChanged(uint32_t nodeId, bool isSupernode)
+{
+  NS_LOG_DEBUG("Node " << nodeId << (isSupernode ? " became" : " is no longer") << " a supernode");
+  Changed();
+}
+
+void
+ConvergenceDetector::SupernodeChanged(uint32_t nodeId, uint32_t supernodeId, uint32_t face)
+{
+  NS_LOG_DEBUG("Node " << nodeId << " joined supernode " << supernodeId << " through face " << face);
+  Changed();
+}
+
+void
+ConvergenceDetector::ConnectorChanged(uint32_t nodeId, bool isConnector)
+{
+  NS_LOG_DEBUG("Node " << nodeId << (isConnector ? " became" : " is no longer") << " a connector");
+  Changed();
+}
+
+void
+ConvergenceDetector::LevelChanged(uint32_t nodeId, uint32_t level)
+{
+  NS_LOG_DEBUG("Node " << nodeId << " became a level-" << level << " supernode");
+  Changed();
+}
+
+void
+ConvergenceDetector::FilterChanged(uint32_t nodeId, uint64_t elementCount)
+{
+  NS_LOG_DEBUG("Domain filter of " << nodeId << " changed");
+  Changed();
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,126 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef CONVERGENCEDETECTOR
+#define CONVERGENCEDETECTOR
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/application.h"
+#include "ns3/traced-callback.h"
+
+#include <set>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief Global observer that detects when the clustering has stabilised
+ *
+ * Listens to the RoleChanged and SupernodeChanged traces of every Clusterconsumer and to
+ * the FilterChanged trace of every supernode application (which are created during the
+ * run, so new applications are picked up on every check). Once no change has been seen
+ * for Window, the clustering is considered converged at the time of the last change and
+ * the configured Action is taken:
+ *
+ *  - "none": only record the convergence time
+ *  - "quiesce" (default): stop the periodic CII and IIM traffic of every node, unless a node
+ *    still needs it (Clusterconsumer::CanQuiesce): services advertised for the sharded
+ *    filters, EpochPeriods, MemberRounds or a rebuild in progress; then it is left running
+ *  - "stop": end the simulation
+ */
+class ConvergenceDetector : public Object {
+public:
+  static TypeId
+  GetTypeId();
+
+  ConvergenceDetector();
+
+  typedef void (*ConvergedCallback)(Time convergenceTime);
+
+  /**
+   * @brief Start observing, must be called after the apps have been installed
+   */
+  void
+  Start();
+
+  /**
+   * @brief Count the clustering restored by ClusterSnapshot::Load as one change now
+   *
+   * The warm start happens before Start, so its changes are not seen; without this a snapshot
+   * that is already settled would never be declared converged.
+   */
+  void
+  WarmStarted();
+
+  bool
+  HasConverged() const;
+
+  /**
+   * @brief Time of the last role, face or filter change before convergence was declared,
+   *        zero until then
+   */
+  Time
+  GetConvergenceTime() const;
+
+private:
+  void
+  Check();
+
+  void
+  ConnectApplications();
+
+  void
+  Changed();
+
+  void
+  RoleChanged(uint32_t nodeId, bool isSupernode);
+
+  void
+  SupernodeChanged(uint32_t nodeId, uint32_t supernodeId, uint32_t face);
+
+  void
+  FilterChanged(uint32_t nodeId, uint64_t elementCount);
+
+  void
+  ConnectorChanged(uint32_t nodeId, bool isConnector);
+
+  void
+  LevelChanged(uint32_t nodeId, uint32_t level);
+
+private:
+  Time m_window;
+  Time m_checkInterval;
+  std::string m_action;
+
+  std::set<Ptr<Application>> m_connected;
+  uint64_t m_changes;
+  Time m_lastChange;
+  bool m_converged;
+  Time m_convergenceTime;
+  EventId m_checkEvent;
+
+  TracedCallback<Time> m_convergedTrace;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif
@@ -0,0 +1,75 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef CSRTOPOLOGY
+#define CSRTOPOLOGY
+
+#include <cstdint>
+#include <cstring>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief Binary topology file, written by Tools/topology-convert and mapped by
+ *        MmapTopologyReader
+ *
+ * Layout (native endianness):
+ *
+ *     CsrTopologyHeader
+ *     uint32_t offsets[nodes + 1]
+ *     uint32_t targets[offsets[nodes]]
+ *
+ * Every undirected link appears in the adjacency of both ends, neighbours are sorted and
+ * unique, and there are no self-loops, i.e. it is exactly a ClusterGraph.
+ */
+struct CsrTopologyHeader
+{
+  char magic[8];
+  uint32_t nodes;
+  uint32_t links; ///< undirected links, offsets[nodes] / 2
+
+  void
+  Init(uint32_t nNodes, uint32_t nLinks)
+  {
+    std::memcpy(magic, GetMagic(), sizeof(magic));
+    nodes = nNodes;
+    links = nLinks;
+  }
+
+  bool
+  IsValid(size_t fileSize) const
+  {
+    return fileSize >= sizeof(CsrTopologyHeader)
+           && std::memcmp(magic, GetMagic(), sizeof(magic)) == 0
+           && fileSize == sizeof(CsrTopologyHeader) + (nodes + 1ULL) * sizeof(uint32_t)
+                            + 2ULL * links * sizeof(uint32_t);
+  }
+
+  static const char*
+  GetMagic()
+  {
+    return "CSRTOPO1";
+  }
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif
@@ -0,0 +1,177 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "mmap-topology-reader.hpp"
+#include "ns3/log.h"
+#include "ns3/string.h"
+
+#include "ns3/ndnSIM/helper/ndn-stack-helper.hpp"
+#include "ns3/ndnSIM/helper/ndn-app-helper.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+NS_LOG_COMPONENT_DEFINE("ndn.MmapTopologyReader");
+
+namespace ns3 {
+namespace ndn {
+
+MmapTopologyReader::MmapTopologyReader(const std::string& fileName)
+  : m_fileName(fileName)
+  , m_mapping(0)
+  , m_length(0)
+  , m_header(0)
+  , m_offsets(0)
+  , m_targets(0)
+{
+  m_p2p.SetDeviceAttribute("DataRate", StringValue("1Gbps"));
+  m_p2p.SetChannelAttribute("Delay", StringValue("10ms"));
+}
+
+MmapTopologyReader::~MmapTopologyReader()
+{
+  Unmap();
+}
+
+PointToPointHelper&
+MmapTopologyReader::GetLinkHelper()
+{
+  return m_p2p;
+}
+
+bool
+MmapTopologyReader::Map()
+{
+  int fd = open(m_fileName.c_str(), O_RDONLY);
+  if (fd < 0) {
+    NS_LOG_ERROR("Cannot open " << m_fileName);
+    return false;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    return false;
+  }
+
+  m_length = st.st_size;
+  m_mapping = mmap(0, m_length, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (m_mapping == MAP_FAILED) {
+    NS_LOG_ERROR("Cannot map " << m_fileName);
+    m_mapping = 0;
+    return false;
+  }
+
+  // the file is read front to back, once to validate it and once to build the nodes
+  madvise(m_mapping, m_length, MADV_SEQUENTIAL);
+
+  m_header = static_cast<const CsrTopologyHeader*>(m_mapping);
+  if (!m_header->IsValid(m_length)) {
+    NS_LOG_ERROR(m_fileName << " is not a CSR topology file");
+    Unmap();
+    return false;
+  }
+
+  m_offsets = reinterpret_cast<const uint32_t*>(m_header + 1);
+  m_targets = m_offsets + m_header->nodes + 1;
+
+  // the header only vouches for the file size, the reader indexes by offsets and targets
+  bool valid = m_offsets[0] == 0 && m_offsets[m_header->nodes] == 2ULL * m_header->links;
+  for (uint32_t i = 0; valid && i < m_header->nodes; i++)
+    valid = m_offsets[i] <= m_offsets[i + 1];
+  for (uint64_t i = 0; valid && i < 2ULL * m_header->links; i++)
+    valid = m_targets[i] < m_header->nodes;
+  if (!valid) {
+    NS_LOG_ERROR(m_fileName << " has malformed offsets or targets");
+    Unmap();
+    return false;
+  }
+  return true;
+}
+
+void
+MmapTopologyReader::Unmap()
+{
+  if (m_mapping != 0)
+    munmap(m_mapping, m_length);
+  m_mapping = 0;
+  m_header = 0;
+  m_offsets = 0;
+  m_targets = 0;
+}
+
+NodeContainer
+MmapTopologyReader::Read()
+{
+  if (!Map())
+    return NodeContainer();
+
+  uint32_t nNodes = m_header->nodes;
+  m_nodes.Create(nNodes);
+
+  // node ids of the file are offsets into m_nodes, every link is stored at both ends and
+  // created from its lower end
+  for (uint32_t v = 0; v < nNodes; v++) {
+    Ptr<Node> node = m_nodes.Get(v);
+    for (uint32_t i = m_offsets[v]; i < m_offsets[v + 1]; i++) {
+      if (m_targets[i] > v)
+        m_p2p.Install(node, m_nodes.Get(m_targets[i]));
+    }
+  }
+
+  NS_LOG_INFO("Read " << nNodes << " nodes and " << m_header->links << " links from "
+              << m_fileName);
+  return m_nodes;
+}
+
+void
+MmapTopologyReader::InstallClusterApps(const std::string& clusterPrefix)
+{
+  StackHelper stackHelper;
+
+  AppHelper consumerHelper("ns3::ndn::Clusterconsumer");
+  consumerHelper.SetPrefix(clusterPrefix);
+
+  AppHelper producerHelper("ns3::ndn::Clusterproducer");
+  producerHelper.SetPrefix("/");
+
+  for (NodeContainer::Iterator node = m_nodes.Begin(); node != m_nodes.End(); node++) {
+    stackHelper.Install(*node);
+    consumerHelper.Install(*node);
+    producerHelper.Install(*node);
+  }
+}
+
+ClusterGraph
+MmapTopologyReader::GetGraph() const
+{
+  ClusterGraph graph;
+  if (m_header == 0)
+    return graph;
+
+  graph.offsets.assign(m_offsets, m_offsets + m_header->nodes + 1);
+  graph.targets.assign(m_targets, m_targets + m_offsets[m_header->nodes]);
+  return graph;
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,100 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef MMAPTOPOLOGYREADER
+#define MMAPTOPOLOGYREADER
+
+#include "ns3/node-container.h"
+#include "ns3/point-to-point-helper.h"
+
+#include "cluster-graph.hpp"
+#include "csr-topology.hpp"
+
+#include <string>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief Loader for very large topologies in the binary CSR format (see CsrTopologyHeader)
+ *
+ * The file is mapped read-only and walked once: all nodes are created in a single call,
+ * then one point-to-point link per undirected edge. InstallClusterApps() then installs the
+ * NDN stack, Clusterconsumer and Clusterproducer node by node in one more pass, so no
+ * intermediate per-link or per-name structures are built as with the text readers.
+ *
+ * Text edge lists are converted with Tools/topology-convert.
+ */
+class MmapTopologyReader {
+public:
+  explicit MmapTopologyReader(const std::string& fileName);
+
+  ~MmapTopologyReader();
+
+  /**
+   * @brief Link attributes used for every edge, defaults to 1Gbps and 10ms
+   */
+  PointToPointHelper&
+  GetLinkHelper();
+
+  /**
+   * @brief Create nodes and links
+   * @returns empty container if the file cannot be mapped or is malformed
+   */
+  NodeContainer
+  Read();
+
+  /**
+   * @brief Install the NDN stack and the clustering apps on every node read
+   */
+  void
+  InstallClusterApps(const std::string& clusterPrefix = "ndn:/localhop/Cluster");
+
+  /**
+   * @brief Adjacency as read from the file, valid after Read()
+   *
+   * Indices are those of the file, which equal ns-3 node ids if Read() created the first
+   * nodes of the simulation.
+   */
+  ClusterGraph
+  GetGraph() const;
+
+private:
+  bool
+  Map();
+
+  void
+  Unmap();
+
+private:
+  std::string m_fileName;
+  PointToPointHelper m_p2p;
+  NodeContainer m_nodes;
+
+  void* m_mapping;
+  size_t m_length;
+  const CsrTopologyHeader* m_header;
+  const uint32_t* m_offsets;
+  const uint32_t* m_targets;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif
@@ -0,0 +1,342 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "service-resolution-tracer.hpp"
+#include "ns3/log.h"
+#include "ns3/callback.h"
+#include "ns3/node-list.h"
+#include "ns3/node.h"
+#include "ns3/net-device.h"
+#include "ns3/channel.h"
+
+#include "ns3/ndnSIM/apps/service-strategy.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+
+NS_LOG_COMPONENT_DEFINE("ServiceResolutionTracer");
+
+namespace ns3 {
+namespace ndn {
+
+NS_OBJECT_ENSURE_REGISTERED(ServiceResolutionTracer);
+
+namespace {
+
+const uint32_t UNREACHABLE = std::numeric_limits<uint32_t>::max();
+const int64_t FAR = std::numeric_limits<int64_t>::max();
+
+typedef std::vector<std::vector<std::pair<uint32_t, int64_t>>> DelayGraph;
+
+/**
+ * @brief One-way delays of the links between the nodes, in nanoseconds
+ *
+ * Read from the Delay attribute of every channel, hopDelay for channels without one. Of
+ * parallel links, the shortest counts.
+ */
+DelayGraph
+GetLinkDelays(uint32_t nNodes, Time hopDelay)
+{
+  DelayGraph links(nNodes);
+  for (uint32_t id = 0; id < nNodes && id < NodeList::GetNNodes(); id++) {
+    Ptr<Node> node = NodeList::GetNode(id);
+    for (uint32_t d = 0; d < node->GetNDevices(); d++) {
+      Ptr<Channel> channel = node->GetDevice(d)->GetChannel();
+      if (channel == 0)
+        continue;
+
+      TimeValue delay(hopDelay);
+      channel->GetAttributeFailSafe("Delay", delay);
+      for (uint32_t c = 0; c < channel->GetNDevices(); c++) {
+        uint32_t other = channel->GetDevice(c)->GetNode()->GetId();
+        if (other != id && other < nNodes)
+          links[id].push_back(std::make_pair(other, delay.Get().GetNanoSeconds()));
+      }
+    }
+  }
+  return links;
+}
+
+} // namespace
+
+TypeId
+ServiceResolutionTracer::GetTypeId(void)
+{
+  static TypeId tid =
+    TypeId("ns3::ndn::ServiceResolutionTracer")
+      .SetGroupName("Ndn")
+      .SetParent<Object>()
+      .AddConstructor<ServiceResolutionTracer>()
+
+      .AddAttribute("HopDelay", "One-way delay of a link without a Delay attribute or with zero delay",
+                    TimeValue(MilliSeconds(10)), MakeTimeAccessor(&ServiceResolutionTracer::m_hopDelay),
+                    MakeTimeChecker(NanoSeconds(1)))
+
+      .AddTraceSource("Resolved", "A request was resolved, with its stretch and latency ratio",
+                      MakeTraceSourceAccessor(&ServiceResolutionTracer::m_resolvedTrace),
+                      "ns3::ndn::ServiceResolutionTracer::ResolvedCallback")
+
+    ;
+
+  return tid;
+}
+
+ServiceResolutionTracer::ServiceResolutionTracer()
+  : m_decisions(nfd::fw::ServiceStrategy::TO_DISTANT + 1, 0)
+  , m_resolutions(0)
+  , m_measured(0)
+  , m_stretchSum(0.0)
+  , m_latencyRatioSum(0.0)
+  , m_cacheLookups(0)
+  , m_cacheHits(0)
+  , m_cacheSavings(0)
+  , m_probes(0)
+  , m_falsePositives(0)
+  , m_rebuilds(0)
+  , m_retirements(0)
+{
+}
+
+void
+ServiceResolutionTracer::AddProvider(const Name& service, uint32_t nodeId)
+{
+  m_providers[service].push_back(nodeId);
+}
+
+void
+ServiceResolutionTracer::Start(const ClusterGraph& graph)
+{
+  NS_LOG_FUNCTION_NOARGS();
+
+  DelayGraph links = GetLinkDelays(graph.GetNNodes(), m_hopDelay);
+
+  for (const auto& service : m_providers) {
+    std::vector<uint32_t>& distance = m_distances[service.first];
+    distance.assign(graph.GetNNodes(), UNREACHABLE);
+
+    std::vector<uint32_t> queue;
+    for (uint32_t provider : service.second) {
+      if (provider < distance.size() && distance[provider] != 0) {
+        distance[provider] = 0;
+        queue.push_back(provider);
+      }
+    }
+    for (size_t head = 0; head < queue.size(); head++) {
+      uint32_t v = queue[head];
+      for (const uint32_t* w = graph.begin(v); w != graph.end(v); w++) {
+        if (distance[*w] == UNREACHABLE) {
+          distance[*w] = distance[v] + 1;
+          queue.push_back(*w);
+        }
+      }
+    }
+
+    // the same from every provider, by link delay (Dijkstra)
+    std::vector<int64_t>& delay = m_delays[service.first];
+    delay.assign(graph.GetNNodes(), FAR);
+    std::priority_queue<std::pair<int64_t, uint32_t>, std::vector<std::pair<int64_t, uint32_t>>,
+                        std::greater<std::pair<int64_t, uint32_t>>> heap;
+    for (uint32_t provider : service.second) {
+      if (provider < delay.size() && delay[provider] != 0) {
+        delay[provider] = 0;
+        heap.push(std::make_pair(0, provider));
+      }
+    }
+    while (!heap.empty()) {
+      std::pair<int64_t, uint32_t> top = heap.top();
+      heap.pop();
+      if (top.first > delay[top.second])
+        continue;
+      for (const auto& link : links[top.second]) {
+        if (top.first + link.second < delay[link.first]) {
+          delay[link.first] = top.first + link.second;
+          heap.push(std::make_pair(delay[link.first], link.first));
+        }
+      }
+    }
+  }
+
+  nfd::fw::ServiceStrategy::GetForwardedTrace().ConnectWithoutContext(
+    MakeCallback(&ServiceResolutionTracer::Forwarded, this));
+  nfd::fw::ServiceStrategy::GetResolvedTrace().ConnectWithoutContext(
+    MakeCallback(&ServiceResolutionTracer::Resolved, this));
+  nfd::fw::ServiceStrategy::GetCacheLookupTrace().ConnectWithoutContext(
+    MakeCallback(&ServiceResolutionTracer::CacheLookup, this));
+  nfd::fw::ServiceStrategy::GetCacheSavingTrace().ConnectWithoutContext(
+    MakeCallback(&ServiceResolutionTracer::CacheSaving, this));
+  nfd::fw::ServiceStrategy::GetProbeTrace().ConnectWithoutContext(
+    MakeCallback(&ServiceResolutionTracer::Probe, this));
+  nfd::fw::ServiceStrategy::GetRebuildTrace().ConnectWithoutContext(
+    MakeCallback(&ServiceResolutionTracer::Rebuild, this));
+  nfd::fw::ServiceStrategy::GetRetireTrace().ConnectWithoutContext(
+    MakeCallback(&ServiceResolutionTracer::Retire, this));
+}
+
+uint64_t
+ServiceResolutionTracer::GetResolutions() const
+{
+  return m_resolutions;
+}
+
+double
+ServiceResolutionTracer::GetMeanStretch() const
+{
+  return m_measured > 0 ? m_stretchSum / m_measured : 0.0;
+}
+
+double
+ServiceResolutionTracer::GetMeanLatencyRatio() const
+{
+  return m_measured > 0 ? m_latencyRatioSum / m_measured : 0.0;
+}
+
+uint64_t
+ServiceResolutionTracer::GetDecisions(uint32_t decision) const
+{
+  return decision < m_decisions.size() ? m_decisions[decision] : 0;
+}
+
+double
+ServiceResolutionTracer::GetCacheHitRate() const
+{
+  return m_cacheLookups > 0 ? static_cast<double>(m_cacheHits) / m_cacheLookups : 0.0;
+}
+
+Time
+ServiceResolutionTracer::GetMeanCacheSaving() const
+{
+  return m_cacheSavings > 0 ? m_cacheSavingSum / m_cacheSavings : Time();
+}
+
+double
+ServiceResolutionTracer::GetFalsePositiveRate() const
+{
+  return m_probes > 0 ? static_cast<double>(m_falsePositives) / m_probes : 0.0;
+}
+
+uint64_t
+ServiceResolutionTracer::GetRebuilds() const
+{
+  return m_rebuilds;
+}
+
+Time
+ServiceResolutionTracer::GetLatencyPercentile(double fraction) const
+{
+  if (m_latencies.empty())
+    return Time();
+
+  std::vector<Time> latencies(m_latencies);
+  size_t rank = std::min(latencies.size() - 1, static_cast<size_t>(fraction * latencies.size()));
+  std::nth_element(latencies.begin(), latencies.begin() + rank, latencies.end());
+  return latencies[rank];
+}
+
+uint64_t
+ServiceResolutionTracer::GetRetirements() const
+{
+  return m_retirements;
+}
+
+void
+ServiceResolutionTracer::Forwarded(uint32_t nodeId, uint32_t decision)
+{
+  if (decision < m_decisions.size())
+    m_decisions[decision]++;
+}
+
+void
+ServiceResolutionTracer::Resolved(uint32_t nodeId, const Name& name, uint32_t hops, Time latency)
+{
+  m_resolutions++;
+  m_latencies.push_back(latency);
+
+  // the service is the longest provider prefix of the request
+  const std::vector<uint32_t>* distance = 0;
+  const std::vector<int64_t>* delay = 0;
+  size_t length = 0;
+  for (const auto& service : m_distances) {
+    if (service.first.size() >= length && service.first.isPrefixOf(name)) {
+      distance = &service.second;
+      delay = &m_delays[service.first];
+      length = service.first.size();
+    }
+  }
+  if (distance == 0 || nodeId >= distance->size() || (*distance)[nodeId] == UNREACHABLE
+      || (*distance)[nodeId] == 0)
+    return;
+
+  uint32_t shortest = (*distance)[nodeId];
+  double stretch = static_cast<double>(hops) / shortest;
+  // zero-delay links leave only the hop count to compare with
+  double roundTrip = (*delay)[nodeId] != FAR && (*delay)[nodeId] > 0
+                       ? 2 * NanoSeconds((*delay)[nodeId]).GetSeconds()
+                       : 2 * shortest * m_hopDelay.GetSeconds();
+  double latencyRatio = latency.GetSeconds() / roundTrip;
+  m_measured++;
+  m_stretchSum += stretch;
+  m_latencyRatioSum += latencyRatio;
+
+  NS_LOG_INFO(name << " resolved by node " << nodeId << " in " << hops << " hops ("
+              << shortest << " flooding), " << latency.GetMilliSeconds() << " ms");
+  m_resolvedTrace(nodeId, stretch, latencyRatio);
+}
+
+void
+ServiceResolutionTracer::CacheLookup(uint32_t nodeId, uint32_t outcome)
+{
+  m_cacheLookups++;
+  if (outcome != nfd::fw::ServiceStrategy::CACHE_MISS)
+    m_cacheHits++;
+}
+
+void
+ServiceResolutionTracer::CacheSaving(uint32_t nodeId, Time saving)
+{
+  m_cacheSavings++;
+  m_cacheSavingSum += saving;
+}
+
+void
+ServiceResolutionTracer::Probe(uint32_t nodeId, uint32_t supernodeId, bool falsePositive)
+{
+  m_probes++;
+  if (falsePositive)
+    m_falsePositives++;
+}
+
+void
+ServiceResolutionTracer::Rebuild(uint32_t nodeId, uint32_t supernodeId)
+{
+  NS_LOG_INFO("Node " << nodeId << " asked " << supernodeId << " to rebuild its filter");
+  m_rebuilds++;
+}
+
+void
+ServiceResolutionTracer::Retire(uint32_t nodeId, uint32_t face)
+{
+  NS_LOG_INFO("Node " << nodeId << " retired face " << face);
+  m_retirements++;
+}
+
+} // namespace ndn
+} // namespace ns3
@@ -0,0 +1,169 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#ifndef SERVICERESOLUTIONTRACER
+#define SERVICERESOLUTIONTRACER
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/traced-callback.h"
+#include "ns3/ndnSIM/model/ndn-common.hpp"
+
+#include "cluster-graph.hpp"
+
+#include <map>
+#include <vector>
+
+namespace ns3 {
+namespace ndn {
+
+/**
+ * @brief Compares the resolutions of ServiceStrategy with flooding
+ *
+ * Flooding reaches the nearest provider of a service over a shortest path, so for every
+ * resolved request the tracer reports
+ *
+ *  - the path stretch: hops of the Data over the shortest distance to a provider, and
+ *  - the latency ratio: resolution latency over the round trip of the path to a provider
+ *    with the least link delay.
+ *
+ * Distances come from one multi-source BFS per service over the ClusterGraph, delays from one
+ * multi-source Dijkstra over the Delay attributes of the nodes' channels. HopDelay stands in
+ * for channels without one, and gives the baseline when all links on the way have zero delay.
+ * Requests served on the requesting node are counted but left out of both means.
+ */
+class ServiceResolutionTracer : public Object {
+public:
+  static TypeId
+  GetTypeId();
+
+  ServiceResolutionTracer();
+
+  typedef void (*ResolvedCallback)(uint32_t nodeId, double stretch, double latencyRatio);
+
+  void
+  AddProvider(const Name& service, uint32_t nodeId);
+
+  /**
+   * @brief Compute the provider distances and connect to the ServiceStrategy traces
+   */
+  void
+  Start(const ClusterGraph& graph);
+
+  uint64_t
+  GetResolutions() const;
+
+  double
+  GetMeanStretch() const;
+
+  double
+  GetMeanLatencyRatio() const;
+
+  /**
+   * @brief ServiceStrategy decisions of one kind, all nodes
+   */
+  uint64_t
+  GetDecisions(uint32_t decision) const;
+
+  /**
+   * @brief Share of supernode resolution cache lookups that hit, negative hits included
+   */
+  double
+  GetCacheHitRate() const;
+
+  /**
+   * @brief Mean latency saved by requests sent to a cached face
+   */
+  Time
+  GetMeanCacheSaving() const;
+
+  /**
+   * @brief Share of the requests sent on supernode filters that were Nacked or timed out
+   */
+  double
+  GetFalsePositiveRate() const;
+
+  /**
+   * @brief Rebuilds asked of noisy supernodes, all nodes
+   */
+  uint64_t
+  GetRebuilds() const;
+
+  /**
+   * @brief Resolution latency at the requesters that fraction of the requests stay within
+   */
+  Time
+  GetLatencyPercentile(double fraction) const;
+
+  /**
+   * @brief Provider faces retired as overloaded, all nodes
+   */
+  uint64_t
+  GetRetirements() const;
+
+private:
+  void
+  Forwarded(uint32_t nodeId, uint32_t decision);
+
+  void
+  Resolved(uint32_t nodeId, const Name& name, uint32_t hops, Time latency);
+
+  void
+  CacheLookup(uint32_t nodeId, uint32_t outcome);
+
+  void
+  CacheSaving(uint32_t nodeId, Time saving);
+
+  void
+  Probe(uint32_t nodeId, uint32_t supernodeId, bool falsePositive);
+
+  void
+  Rebuild(uint32_t nodeId, uint32_t supernodeId);
+
+  void
+  Retire(uint32_t nodeId, uint32_t face);
+
+private:
+  Time m_hopDelay;
+
+  std::map<Name, std::vector<uint32_t>> m_providers;
+  std::map<Name, std::vector<uint32_t>> m_distances; // by service, hops of every node to a provider
+  std::map<Name, std::vector<int64_t>> m_delays;     // by service, ns of every node to a provider
+  std::vector<uint64_t> m_decisions;
+  uint64_t m_resolutions;
+  uint64_t m_measured; // resolutions with a provider at least one hop away
+  double m_stretchSum;
+  double m_latencyRatioSum;
+  uint64_t m_cacheLookups;
+  uint64_t m_cacheHits;
+  uint64_t m_cacheSavings;
+  Time m_cacheSavingSum;
+  uint64_t m_probes;
+  uint64_t m_falsePositives;
+  uint64_t m_rebuilds;
+  uint64_t m_retirements;
+  std::vector<Time> m_latencies;
+
+  TracedCallback<uint32_t, double, double> m_resolvedTrace;
+};
+
+} // namespace ndn
+} // namespace ns3
+
+#endif
@@ -0,0 +1,332 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+#include "ns3/core-module.h"
+
+#include "ns3/ndnSIM/apps/filter-trust.hpp"
+#include "ns3/ndnSIM/apps/member-filter-table.hpp"
+#include "ns3/ndnSIM/apps/provider-balancer.hpp"
+#include "ns3/ndnSIM/apps/resource-class.hpp"
+#include "ns3/ndnSIM/apps/resolution-cache.hpp"
+#include "ns3/ndnSIM/apps/sharded-filter.hpp"
+
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * Standalone check of the data structures of the supernode and the service strategy.
+ *
+ * Runs no simulation: ResolutionCache (insert, erase across a probe run that wraps around the
+ * table, CLOCK eviction when full, expiry), FilterTrust, ResourceClass, ProviderBalancer,
+ * ShardedFilter and MemberFilterTable are driven directly and compared with what their documentation promises.
+ * Every failed expectation is printed to stderr and the program exits with status 1, like the
+ * clustering scenario's --check.
+ */
+namespace {
+
+uint32_t g_checks = 0;
+uint32_t g_failures = 0;
+
+void
+Expect(bool ok, const std::string& what)
+{
+  g_checks++;
+  if (!ok) {
+    g_failures++;
+    std::cerr << "FAILED: " << what << std::endl;
+  }
+}
+
+ndn::Name
+MakeService(uint32_t i)
+{
+  return ndn::Name("/service/" + std::to_string(i));
+}
+
+void
+CheckResolutionCache()
+{
+  // capacity 4 gives 8 slots; three names whose home is the last slot wrap around the table
+  ndn::ResolutionCache cache(4);
+  std::vector<ndn::Name> wrapped;
+  for (uint32_t i = 0; wrapped.size() < 3; i++) {
+    if ((std::hash<ndn::Name>()(MakeService(i)) & 7) == 7)
+      wrapped.push_back(MakeService(i));
+  }
+
+  Time now = Seconds(1);
+  Time expiry = Seconds(10);
+  for (size_t i = 0; i < wrapped.size(); i++)
+    cache.InsertPositive(wrapped[i], i + 1, MilliSeconds(5), expiry);
+  Expect(cache.GetSize() == 3, "cache holds the three entries of the wrapped run");
+
+  cache.Erase(wrapped[0]);
+  Expect(cache.GetSize() == 2, "erase drops one entry");
+  Expect(cache.Find(wrapped[0], now) == 0, "an erased entry is not found");
+  for (size_t i = 1; i < wrapped.size(); i++) {
+    const ndn::ResolutionCache::Entry* entry = cache.Find(wrapped[i], now);
+    Expect(entry != 0 && entry->face == i + 1,
+           "an entry behind the erased one in the wrapped run is still found");
+  }
+
+  cache.Erase(wrapped[1]);
+  const ndn::ResolutionCache::Entry* last = cache.Find(wrapped[2], now);
+  Expect(last != 0 && last->face == 3, "the end of the wrapped run survives a second erase");
+
+  cache.InsertNegative(wrapped[2], expiry);
+  last = cache.Find(wrapped[2], now);
+  Expect(last != 0 && last->negative && cache.GetSize() == 1,
+         "a negative entry replaces the positive one in place");
+  Expect(cache.Find(wrapped[2], expiry) == 0 && cache.GetSize() == 0,
+         "an entry is dropped once it has expired");
+
+  // a full table evicts the one entry that was not hit since the last sweep
+  ndn::ResolutionCache full(4);
+  for (uint32_t i = 0; i < 4; i++)
+    full.InsertPositive(MakeService(i), i + 1, MilliSeconds(5), expiry);
+  for (uint32_t i : {0, 1, 3})
+    full.Find(MakeService(i), now);
+  full.InsertPositive(MakeService(4), 5, MilliSeconds(5), expiry);
+  Expect(full.GetSize() == 4, "a full cache stays at its capacity");
+  Expect(full.Find(MakeService(2), now) == 0, "CLOCK evicts the entry that was not hit");
+  for (uint32_t i : {0, 1, 3, 4})
+    Expect(full.Find(MakeService(i), now) != 0, "CLOCK keeps the entries that were hit");
+
+  ndn::ResolutionCache none(0);
+  none.InsertPositive(MakeService(0), 1, MilliSeconds(5), expiry);
+  Expect(none.GetSize() == 0 && none.Find(MakeService(0), now) == 0,
+         "a cache of capacity 0 holds nothing");
+}
+
+void
+CheckFilterTrust()
+{
+  ndn::FilterTrust trust(0.2, Seconds(30));
+  for (uint32_t i = 0; i + 1 < ndn::FilterTrust::MIN_SAMPLES; i++)
+    trust.Record(1, true);
+  Expect(trust.GetRate(1, 0.01) == 0.01, "the predicted rate stands in for too few samples");
+  Expect(!trust.ShouldRebuild(1, Seconds(1)), "too few samples ask for no rebuild");
+
+  trust.Record(1, true);
+  Expect(trust.GetRate(1, 0.01) == 1.0, "the observed rate replaces the predicted one");
+  Expect(trust.ShouldRebuild(1, Seconds(1)), "a noisy filter is due for a rebuild");
+  Expect(trust.GetRate(1, 0.01) == 0.01, "the samples start over after a rebuild request");
+
+  for (uint32_t i = 0; i < ndn::FilterTrust::MIN_SAMPLES; i++)
+    trust.Record(1, true);
+  Expect(!trust.ShouldRebuild(1, Seconds(10)), "no second rebuild within the hold-down");
+  Expect(trust.ShouldRebuild(1, Seconds(31)), "a second rebuild after the hold-down");
+
+  for (uint32_t i = 0; i < ndn::FilterTrust::MIN_SAMPLES; i++)
+    trust.Record(2, false);
+  Expect(!trust.ShouldRebuild(2, Seconds(1)), "a filter without false positives is kept");
+
+  ndn::FilterTrust never(0.0, Seconds(30));
+  for (uint32_t i = 0; i < ndn::FilterTrust::MIN_SAMPLES; i++)
+    never.Record(1, true);
+  Expect(!never.ShouldRebuild(1, Seconds(1)), "a noisy rate of 0 never asks for a rebuild");
+}
+
+void
+CheckResourceClass()
+{
+  using ndn::ResourceClass;
+  Expect(ResourceClass::Quantise(0.0) == 0 && ResourceClass::Quantise(0.99) == 0,
+         "values below 1 fall into class 0");
+  Expect(ResourceClass::Quantise(1.0) == 1 && ResourceClass::Quantise(1.99) == 1,
+         "class 1 starts at 1");
+  Expect(ResourceClass::Quantise(2.0) == 2 && ResourceClass::Quantise(3.99) == 2,
+         "class 2 starts at 2");
+  Expect(ResourceClass::Quantise(4.0) == ResourceClass::CLASSES - 1
+           && ResourceClass::Quantise(1e6) == ResourceClass::CLASSES - 1,
+         "the last class is open-ended");
+
+  bloom_filter filter = ndn::ShardedFilter::MakeShape(ndn::ShardedFilter::MIN_CAPACITY);
+  ResourceClass::Insert(filter, MakeService(1), 2.5, 1.0);
+  Expect(ResourceClass::Contains(filter, MakeService(1), 2, 1), "the exact classes are found");
+  Expect(ResourceClass::Contains(filter, MakeService(1), 0, 0)
+           && ResourceClass::Contains(filter, MakeService(1), 1, 1),
+         "lower minimum classes are found (at least)");
+  Expect(!ResourceClass::Contains(filter, MakeService(1), 3, 1)
+           && !ResourceClass::Contains(filter, MakeService(1), 2, 2),
+         "a higher minimum class is not found");
+  Expect(!ResourceClass::Contains(filter, MakeService(2), 0, 0), "another service is not found");
+}
+
+void
+CheckProviderBalancer()
+{
+  std::mt19937 rng(1);
+  ndn::ProviderBalancer balancer(2, Seconds(1));
+  Time now = Seconds(1);
+
+  Expect(balancer.Pick(std::vector<uint64_t>(), now, rng) == 0, "no candidates pick 0");
+  Expect(balancer.Pick(std::vector<uint64_t>{7}, now, rng) == 7, "one candidate is picked");
+  Expect(balancer.GetTimeout(1) == Time(), "no timeout before the first RTT");
+
+  balancer.Answered(1, MilliSeconds(10));
+  balancer.Answered(2, MilliSeconds(100));
+  Expect(balancer.GetTimeout(1) == MilliSeconds(20), "the timeout is twice the SRTT");
+
+  std::vector<uint64_t> both{1, 2};
+  bool faster = true;
+  for (uint32_t i = 0; i < 20; i++)
+    faster = faster && balancer.Pick(both, now, rng) == 1;
+  Expect(faster, "of two candidates the one with the lower RTT is picked");
+
+  Expect(!balancer.Sent(1, now) && !balancer.Sent(1, now), "n requests in flight are fine");
+  Expect(balancer.Sent(1, now), "request n + 1 in flight retires the provider");
+  Expect(balancer.IsRetired(1, now), "a retired provider is retired");
+  Expect(balancer.Pick(both, now, rng) == 2, "a retired provider is passed over");
+  Expect(!balancer.IsRetired(1, now + Seconds(1)), "retirement ends after the retire time");
+
+  Expect(!balancer.Failed(2, false, now) && !balancer.Failed(2, false, now),
+         "two failures in a row are tolerated");
+  Expect(balancer.Failed(2, false, now), "the third failure in a row retires the provider");
+  Expect(balancer.Failed(3, true, now), "a congestion Nack retires the provider at once");
+
+  std::vector<uint64_t> retired{2, 3};
+  uint64_t picked = balancer.Pick(retired, now, rng);
+  Expect(picked == 2 || picked == 3, "with every candidate retired, one is still picked");
+}
+
+void
+CheckShardedFilter()
+{
+  ndn::ShardedFilter sharded(0.01);
+  Time period = Seconds(1);
+  uint32_t shard = ndn::ShardedFilter::GetShard(MakeService(0));
+
+  Expect(sharded.Get(shard) == 0, "a shard without merges is empty");
+  Expect(sharded.GetCapacity(shard) == ndn::ShardedFilter::MIN_CAPACITY,
+         "a new shard starts at the least capacity");
+
+  bloom_filter small = ndn::ShardedFilter::MakeShape(ndn::ShardedFilter::MIN_CAPACITY);
+  small.insert(MakeService(0).toUri());
+  sharded.Merge(shard, small);
+  Expect(sharded.Get(shard) != 0 && sharded.Get(shard)->contains(MakeService(0).toUri()),
+         "a merged name is in its shard");
+  Expect(sharded.TakeChanged(false).size() == 1 && sharded.TakeChanged(false).empty(),
+         "a changed shard is reported once");
+
+  bloom_filter other = ndn::ShardedFilter::MakeShape(ndn::ShardedFilter::MIN_CAPACITY * 4);
+  sharded.Merge(shard, other);
+  Expect(sharded.Get(shard)->size() == small.size(), "a filter of another shape is dropped");
+
+  // four times the capacity fills the shard well past twice the target rate
+  for (uint32_t i = 1; i < 4 * ndn::ShardedFilter::MIN_CAPACITY; i++)
+    small.insert(MakeService(i).toUri());
+  sharded.Merge(shard, small);
+  sharded.Update(Seconds(1), period);
+  Expect(sharded.GetCapacity(shard) == 2 * ndn::ShardedFilter::MIN_CAPACITY,
+         "a crowded shard doubles its capacity");
+
+  sharded.Update(Seconds(3), period);
+  Expect(sharded.Get(shard)->size() == small.size(),
+         "the old table keeps serving until a filter of the new capacity arrives");
+
+  bloom_filter large = ndn::ShardedFilter::MakeShape(2 * ndn::ShardedFilter::MIN_CAPACITY);
+  large.insert(MakeService(0).toUri());
+  sharded.Merge(shard, large);
+  sharded.Update(Seconds(4), period);
+  Expect(sharded.Get(shard)->size() == large.size()
+           && sharded.Get(shard)->contains(MakeService(0).toUri()),
+         "the refilled table replaces the old one");
+}
+
+bool
+SameTable(const uint8_t* aggregate, const bloom_filter& expected, size_t bytes)
+{
+  return std::memcmp(aggregate, expected.table(), bytes) == 0;
+}
+
+void
+CheckMemberFilterTable()
+{
+  bloom_filter shape = ndn::ShardedFilter::MakeShape(ndn::ShardedFilter::MIN_CAPACITY);
+  ndn::MemberFilterTable table(shape);
+  std::mt19937 rng(1);
+  std::map<uint32_t, bloom_filter> members;
+
+  bool same = true;
+  for (uint32_t step = 0; step < 2000; step++) {
+    uint32_t member = rng() % 40;
+    if (rng() % 4 == 0) {
+      table.Remove(member);
+      members.erase(member);
+    }
+    else {
+      bloom_filter filter = shape;
+      filter.insert(MakeService(rng() % 1000).toUri());
+      table.Update(member, filter, NanoSeconds(step));
+      members[member] = filter;
+    }
+
+    if (step % 10 == 0) {
+      bloom_filter expected = shape;
+      for (const auto& entry : members)
+        expected |= entry.second;
+      same = same && SameTable(table.GetAggregate(), expected, table.GetTableBytes());
+    }
+  }
+  Expect(same, "the aggregate is the OR of the members' filters");
+  Expect(table.GetSize() == members.size(), "the table holds one filter per member");
+
+  bloom_filter wrong = ndn::ShardedFilter::MakeShape(2 * ndn::ShardedFilter::MIN_CAPACITY);
+  Expect(!table.Update(1000, wrong, Seconds(1)) && table.GetSize() == members.size(),
+         "a filter of another size is refused");
+
+  table.Expire(Seconds(1));
+  Expect(table.GetSize() == 0 && SameTable(table.GetAggregate(), shape, table.GetTableBytes()),
+         "expiring every member leaves an empty aggregate");
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  CommandLine cmd;
+  cmd.Parse(argc, argv);
+
+  CheckResolutionCache();
+  CheckFilterTrust();
+  CheckResourceClass();
+  CheckProviderBalancer();
+  CheckShardedFilter();
+  CheckMemberFilterTable();
+
+  std::cerr << g_checks << " checks, " << g_failures << " failed" << std::endl;
+  return g_failures == 0 ? 0 : 1;
+}
+
+} // namespace ns3
+
+int
+main(int argc, char* argv[])
+{
+  return ns3::main(argc, argv);
+}
@@ -0,0 +1,583 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+/**
+ * Parallel parameter sweep over the clustering scenario.
+ *
+ * Usage:
+ *     sweep-runner <sweep-file> <scenario-binary> [--jobs N] [--manifest FILE] [--csv FILE]
+ *                  [--timeout SECONDS]
+ *
+ * The sweep file lists one parameter per line as "name = value value ...". Every
+ * combination of values is run once per seed, where seeds are given by the special
+ * "seeds" parameter ("seeds = 1-100" or "seeds = 1 2 3") and passed as --RngRun.
+ * All other parameters are passed to the scenario as --name=value:
+ *
+ *     seeds = 1-50
+ *     ns3::ndn::Clusterconsumer::Frequency = 0.5 1 2
+ *     ns3::ndn::Clusterconsumer::Randomize = none uniform
+ *     rows = 10 20
+ *
+ * Each finished run is appended to the manifest (and flushed to disk) together with the
+ * METRICS line printed by the scenario, so an interrupted sweep is resumed by re-running
+ * the same command: runs already in the manifest are not started again. Once all runs are
+ * done, every metric is aggregated per configuration into a percentile table. Manifest
+ * entries of configurations or seeds the sweep file no longer lists are left out.
+ **/
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+struct Parameter
+{
+  std::string name;
+  std::vector<std::string> values;
+};
+
+struct Run
+{
+  std::string config; // canonical "name=value name=value" string, without the seed
+  std::vector<std::string> args;
+  uint32_t seed;
+};
+
+typedef std::map<std::string, double> Metrics;
+
+std::string
+Trim(const std::string& s)
+{
+  size_t begin = s.find_first_not_of(" \t\r");
+  if (begin == std::string::npos)
+    return "";
+  size_t end = s.find_last_not_of(" \t\r");
+  return s.substr(begin, end - begin + 1);
+}
+
+std::vector<std::string>
+Split(const std::string& s)
+{
+  std::vector<std::string> tokens;
+  std::istringstream is(s);
+  std::string token;
+  while (is >> token)
+    tokens.push_back(token);
+  return tokens;
+}
+
+/**
+ * @brief Parse a whole number of at most max, with nothing before or after it
+ */
+bool
+ParseUnsigned(const std::string& value, unsigned long max, unsigned long& result)
+{
+  if (value.empty() || value.find_first_not_of("0123456789") != std::string::npos)
+    return false;
+
+  char* end = nullptr;
+  errno = 0;
+  result = std::strtoul(value.c_str(), &end, 10);
+  return errno == 0 && *end == '\0' && result <= max;
+}
+
+/**
+ * @throws std::logic_error unless value is a whole number that fits a seed
+ */
+uint32_t
+ParseSeed(const std::string& value)
+{
+  size_t end = 0;
+  unsigned long seed = std::stoul(value, &end);
+  if (end != value.size())
+    throw std::invalid_argument(value);
+  if (seed > std::numeric_limits<uint32_t>::max())
+    throw std::out_of_range(value);
+  return seed;
+}
+
+/**
+ * @throws std::logic_error on a value that is neither a seed nor a range of seeds
+ */
+std::vector<uint32_t>
+ParseSeeds(const std::vector<std::string>& values)
+{
+  std::vector<uint32_t> seeds;
+  for (const std::string& value : values) {
+    size_t dash = value.find('-');
+    if (dash == std::string::npos) {
+      seeds.push_back(ParseSeed(value));
+    }
+    else {
+      uint64_t first = ParseSeed(value.substr(0, dash));
+      uint64_t last = ParseSeed(value.substr(dash + 1));
+      for (uint64_t seed = first; seed <= last; seed++)
+        seeds.push_back(seed);
+    }
+  }
+  return seeds;
+}
+
+bool
+ReadSweep(const std::string& fileName, std::vector<Parameter>& parameters, std::vector<uint32_t>& seeds)
+{
+  std::ifstream file(fileName);
+  if (!file) {
+    std::cerr << "Cannot open sweep file " << fileName << std::endl;
+    return false;
+  }
+
+  std::string line;
+  while (std::getline(file, line)) {
+    line = Trim(line.substr(0, line.find('#')));
+    if (line.empty())
+      continue;
+
+    size_t eq = line.find('=');
+    if (eq == std::string::npos) {
+      std::cerr << "Malformed sweep line: " << line << std::endl;
+      return false;
+    }
+
+    Parameter parameter = {Trim(line.substr(0, eq)), Split(line.substr(eq + 1))};
+    if (parameter.values.empty()) {
+      std::cerr << "No values for " << parameter.name << std::endl;
+      return false;
+    }
+
+    if (parameter.name == "seeds") {
+      try {
+        seeds = ParseSeeds(parameter.values);
+      }
+      catch (const std::logic_error&) {
+        std::cerr << "Malformed seeds line: " << line << std::endl;
+        return false;
+      }
+    }
+    else {
+      parameters.push_back(parameter);
+    }
+  }
+
+  if (seeds.empty())
+    seeds.push_back(1);
+  return true;
+}
+
+std::vector<Run>
+ExpandRuns(const std::vector<Parameter>& parameters, const std::vector<uint32_t>& seeds)
+{
+  std::vector<Run> runs;
+  std::vector<size_t> index(parameters.size(), 0);
+
+  while (true) {
+    std::string config;
+    std::vector<std::string> args;
+    for (size_t i = 0; i < parameters.size(); i++) {
+      const std::string& value = parameters[i].values[index[i]];
+      config += (i > 0 ? " " : "") + parameters[i].name + "=" + value;
+      args.push_back("--" + parameters[i].name + "=" + value);
+    }
+
+    for (uint32_t seed : seeds)
+      runs.push_back({config, args, seed});
+
+    // odometer-style increment over all parameter value lists
+    size_t i = 0;
+    for (; i < parameters.size(); i++) {
+      if (++index[i] < parameters[i].values.size())
+        break;
+      index[i] = 0;
+    }
+    if (i == parameters.size())
+      break;
+  }
+
+  return runs;
+}
+
+std::string
+RunKey(const std::string& config, uint32_t seed)
+{
+  return config + "\t" + std::to_string(seed);
+}
+
+/**
+ * Manifest lines: "<config>\t<seed>\t<status>\t<metrics line>"
+ */
+class Manifest {
+public:
+  explicit Manifest(const std::string& fileName)
+    : m_fileName(fileName)
+    , m_fd(-1)
+  {
+  }
+
+  ~Manifest()
+  {
+    if (m_fd >= 0)
+      close(m_fd);
+  }
+
+  /**
+   * Reads the finished runs, keyed by RunKey. Returns the number of unreadable lines, which
+   * are skipped like failed runs.
+   */
+  size_t
+  Load(std::map<std::string, Metrics>& done) const
+  {
+    std::ifstream file(m_fileName);
+    std::string line;
+    size_t unreadable = 0;
+    while (std::getline(file, line)) {
+      std::vector<std::string> fields;
+      size_t start = 0;
+      for (int i = 0; i < 3; i++) {
+        size_t tab = line.find('\t', start);
+        if (tab == std::string::npos)
+          break;
+        fields.push_back(line.substr(start, tab - start));
+        start = tab + 1;
+      }
+      if (fields.size() != 3 || fields[2] != "ok")
+        continue; // failed or truncated entries are simply run again
+
+      unsigned long seed;
+      if (!ParseUnsigned(fields[1], std::numeric_limits<uint32_t>::max(), seed)) {
+        unreadable++;
+        continue;
+      }
+      done[RunKey(fields[0], seed)] = ParseMetrics(line.substr(start));
+    }
+    return unreadable;
+  }
+
+  bool
+  Open()
+  {
+    m_fd = open(m_fileName.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (m_fd < 0)
+      std::cerr << "Cannot open manifest " << m_fileName << ": " << strerror(errno) << std::endl;
+    return m_fd >= 0;
+  }
+
+  void
+  Append(const Run& run, bool ok, const std::string& metricsLine)
+  {
+    std::string line = run.config + "\t" + std::to_string(run.seed) + "\t" + (ok ? "ok" : "failed")
+                       + "\t" + metricsLine + "\n";
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    // a single write() on an O_APPEND descriptor, so a crash never interleaves entries
+    if (write(m_fd, line.data(), line.size()) != static_cast<ssize_t>(line.size()))
+      std::cerr << "Short write to manifest: " << strerror(errno) << std::endl;
+    fsync(m_fd);
+  }
+
+  static Metrics
+  ParseMetrics(const std::string& line)
+  {
+    Metrics metrics;
+    for (const std::string& token : Split(line)) {
+      size_t eq = token.find('=');
+      if (eq == std::string::npos)
+        continue;
+      metrics[token.substr(0, eq)] = std::strtod(token.c_str() + eq + 1, nullptr);
+    }
+    return metrics;
+  }
+
+private:
+  std::string m_fileName;
+  int m_fd;
+  std::mutex m_mutex;
+};
+
+/**
+ * Runs the scenario binary and returns the METRICS line of its standard output
+ */
+bool
+Execute(const std::string& binary, const Run& run, unsigned timeout, std::string& metricsLine)
+{
+  // built before fork(), the child of a threaded process should only exec
+  std::vector<std::string> args = run.args;
+  args.insert(args.begin(), binary);
+  args.push_back("--RngRun=" + std::to_string(run.seed));
+
+  std::vector<char*> argv;
+  for (std::string& arg : args)
+    argv.push_back(&arg[0]);
+  argv.push_back(nullptr);
+
+  // close-on-exec, so the children of the other workers do not hold this pipe open
+  int pipeFd[2];
+  if (pipe2(pipeFd, O_CLOEXEC) != 0)
+    return false;
+
+  pid_t pid = fork();
+  if (pid < 0) {
+    close(pipeFd[0]);
+    close(pipeFd[1]);
+    return false;
+  }
+
+  if (pid == 0) {
+    dup2(pipeFd[1], STDOUT_FILENO);
+    close(pipeFd[0]);
+    close(pipeFd[1]);
+
+    int devNull = open("/dev/null", O_WRONLY | O_CLOEXEC);
+    if (devNull >= 0)
+      dup2(devNull, STDERR_FILENO);
+
+    if (timeout > 0)
+      alarm(timeout); // SIGALRM terminates a hung simulation
+
+    execv(binary.c_str(), argv.data());
+    _exit(127);
+  }
+
+  close(pipeFd[1]);
+
+  std::string output;
+  char buffer[4096];
+  ssize_t n;
+  while ((n = read(pipeFd[0], buffer, sizeof(buffer))) > 0 || (n < 0 && errno == EINTR)) {
+    if (n > 0)
+      output.append(buffer, n);
+  }
+  close(pipeFd[0]);
+
+  int status = 0;
+  while (waitpid(pid, &status, 0) < 0 && errno == EINTR)
+    ;
+
+  if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+    return false;
+
+  std::istringstream is(output);
+  std::string line;
+  while (std::getline(is, line)) {
+    if (line.compare(0, 8, "METRICS ") == 0)
+      metricsLine = line.substr(8);
+  }
+  return !metricsLine.empty();
+}
+
+/**
+ * Nearest-rank percentile of a sorted sample
+ */
+double
+Percentile(const std::vector<double>& sorted, double p)
+{
+  if (sorted.empty())
+    return NAN;
+  size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * sorted.size()));
+  return sorted[std::min(std::max<size_t>(rank, 1), sorted.size()) - 1];
+}
+
+void
+Aggregate(const std::map<std::string, std::vector<Metrics>>& results, std::ostream& table,
+          std::ostream* csv)
+{
+  static const double percentiles[] = {50, 90, 99};
+
+  if (csv != nullptr)
+    *csv << "config,metric,runs,min,mean,p50,p90,p99,max\n";
+
+  for (const auto& config : results) {
+    std::map<std::string, std::vector<double>> samples;
+    for (const Metrics& metrics : config.second)
+      for (const auto& metric : metrics)
+        samples[metric.first].push_back(metric.second);
+
+    table << "\n" << (config.first.empty() ? "(default)" : config.first) << "  ["
+          << config.second.size() << " runs]\n";
+    table << "  " << std::left << std::setw(14) << "metric" << std::right
+          << std::setw(12) << "min" << std::setw(12) << "mean" << std::setw(12) << "p50"
+          << std::setw(12) << "p90" << std::setw(12) << "p99" << std::setw(12) << "max" << "\n";
+
+    for (auto& metric : samples) {
+      std::vector<double>& values = metric.second;
+      std::sort(values.begin(), values.end());
+      double mean = 0;
+      for (double value : values)
+        mean += value;
+      mean /= values.size();
+
+      table << "  " << std::left << std::setw(14) << metric.first << std::right
+            << std::setprecision(6) << std::setw(12) << values.front() << std::setw(12) << mean;
+      for (double p : percentiles)
+        table << std::setw(12) << Percentile(values, p);
+      table << std::setw(12) << values.back() << "\n";
+
+      if (csv != nullptr) {
+        *csv << "\"" << config.first << "\"," << metric.first << "," << values.size() << ","
+             << values.front() << "," << mean;
+        for (double p : percentiles)
+          *csv << "," << Percentile(values, p);
+        *csv << "," << values.back() << "\n";
+      }
+    }
+  }
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  if (argc < 3) {
+    std::cerr << "Usage: " << argv[0] << " <sweep-file> <scenario-binary> [--jobs N]"
+              << " [--manifest FILE] [--csv FILE] [--timeout SECONDS]" << std::endl;
+    return 1;
+  }
+
+  std::string sweepFile = argv[1];
+  std::string binary = argv[2];
+  std::string manifestFile = sweepFile + ".manifest";
+  std::string csvFile;
+  unsigned jobs = std::max(1u, std::thread::hardware_concurrency());
+  unsigned timeout = 0;
+
+  for (int i = 3; i < argc; i += 2) {
+    std::string option = argv[i];
+    if (i + 1 == argc) {
+      std::cerr << "No value for option " << option << std::endl;
+      return 1;
+    }
+    unsigned long value = 0;
+    if ((option == "--jobs" || option == "--timeout")
+        && !ParseUnsigned(argv[i + 1], std::numeric_limits<unsigned>::max(), value)) {
+      std::cerr << "Invalid value for option " << option << ": " << argv[i + 1] << std::endl;
+      return 1;
+    }
+
+    if (option == "--jobs")
+      jobs = std::max(1ul, value);
+    else if (option == "--manifest")
+      manifestFile = argv[i + 1];
+    else if (option == "--csv")
+      csvFile = argv[i + 1];
+    else if (option == "--timeout")
+      timeout = value;
+    else {
+      std::cerr << "Unknown option " << option << std::endl;
+      return 1;
+    }
+  }
+
+  std::vector<Parameter> parameters;
+  std::vector<uint32_t> seeds;
+  if (!ReadSweep(sweepFile, parameters, seeds))
+    return 1;
+
+  std::vector<Run> runs = ExpandRuns(parameters, seeds);
+
+  Manifest manifest(manifestFile);
+  std::map<std::string, Metrics> done;
+  size_t unreadable = manifest.Load(done);
+  if (unreadable > 0)
+    std::cerr << unreadable << " unreadable manifest lines skipped" << std::endl;
+  if (!manifest.Open())
+    return 1;
+
+  // work queue: everything not already recorded in the manifest. Only runs of the current
+  // sweep are aggregated, not those left in the manifest by an earlier version of the file
+  std::vector<Run> queue;
+  std::map<std::string, std::vector<Metrics>> results;
+  for (const Run& run : runs) {
+    auto entry = done.find(RunKey(run.config, run.seed));
+    if (entry == done.end())
+      queue.push_back(run);
+    else
+      results[run.config].push_back(entry->second);
+  }
+
+  std::cerr << runs.size() << " runs, " << runs.size() - queue.size() << " already done, "
+            << jobs << " workers" << std::endl;
+
+  std::mutex mutex;
+  size_t next = 0;
+  size_t finished = 0;
+  size_t failed = 0;
+
+  auto worker = [&] {
+    while (true) {
+      size_t index;
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (next == queue.size())
+          return;
+        index = next++;
+      }
+
+      const Run& run = queue[index];
+      std::string metricsLine;
+      bool ok = Execute(binary, run, timeout, metricsLine);
+      manifest.Append(run, ok, metricsLine);
+
+      std::lock_guard<std::mutex> lock(mutex);
+      finished++;
+      if (ok)
+        results[run.config].push_back(Manifest::ParseMetrics(metricsLine));
+      else {
+        failed++;
+        std::cerr << "Run failed: " << run.config << " seed " << run.seed << std::endl;
+      }
+      std::cerr << "\r" << finished << "/" << queue.size() << " done" << std::flush;
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (unsigned i = 0; i < std::min<size_t>(jobs, queue.size()); i++)
+    workers.emplace_back(worker);
+  for (std::thread& thread : workers)
+    thread.join();
+  std::cerr << std::endl;
+
+  std::ofstream csv;
+  if (!csvFile.empty())
+    csv.open(csvFile);
+  Aggregate(results, std::cout, csv.is_open() ? &csv : nullptr);
+
+  if (failed > 0) {
+    std::cerr << failed << " runs failed and will be retried on the next invocation" << std::endl;
+    return 2;
+  }
+  return 0;
+}
@@ -0,0 +1,169 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/**
+ * Copyright (c) 2011-2015  Regents of the University of California.
+ *
+ * This file is part of ndnSIM. See AUTHORS for complete list of ndnSIM authors and
+ * contributors.
+ *
+ * ndnSIM is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * ndnSIM is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * ndnSIM, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ **/
+
+/**
+ * Converts a text edge list into the binary CSR topology read by MmapTopologyReader.
+ *
+ * Usage:
+ *     topology-convert <edge-list> <output>
+ *
+ * The edge list has one link per line, "<node> <node>", with '#' starting a comment. Node
+ * ids are arbitrary non-negative integers and are renumbered densely in increasing order,
+ * so ns-3 node i is the i-th smallest id of the input. Self-loops and duplicate links are
+ * dropped.
+ **/
+
+#include "../Scenarios/csr-topology.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+bool
+ReadEdges(const char* fileName, std::vector<uint64_t>& from, std::vector<uint64_t>& to)
+{
+  FILE* file = std::fopen(fileName, "r");
+  if (file == nullptr) {
+    std::cerr << "Cannot open " << fileName << std::endl;
+    return false;
+  }
+
+  char line[256];
+  size_t lineNo = 0;
+  while (std::fgets(line, sizeof(line), file) != nullptr) {
+    lineNo++;
+    char* p = line;
+    while (*p == ' ' || *p == '\t')
+      p++;
+    if (*p == '#' || *p == '\n' || *p == '\r' || *p == '\0')
+      continue;
+
+    char* end;
+    uint64_t a = std::strtoull(p, &end, 10);
+    if (end == p) {
+      std::cerr << fileName << ":" << lineNo << ": malformed link" << std::endl;
+      std::fclose(file);
+      return false;
+    }
+    p = end;
+    uint64_t b = std::strtoull(p, &end, 10);
+    if (end == p) {
+      std::cerr << fileName << ":" << lineNo << ": malformed link" << std::endl;
+      std::fclose(file);
+      return false;
+    }
+
+    if (a != b) {
+      from.push_back(a);
+      to.push_back(b);
+    }
+  }
+
+  std::fclose(file);
+  return true;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  if (argc != 3) {
+    std::cerr << "Usage: " << argv[0] << " <edge-list> <output>" << std::endl;
+    return 1;
+  }
+
+  std::vector<uint64_t> from, to;
+  if (!ReadEdges(argv[1], from, to))
+    return 1;
+
+  // dense renumbering
+  std::vector<uint64_t> ids(from);
+  ids.insert(ids.end(), to.begin(), to.end());
+  std::sort(ids.begin(), ids.end());
+  ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+  if (ids.size() >= UINT32_MAX || 2 * from.size() >= UINT32_MAX) {
+    std::cerr << "Topology too large" << std::endl;
+    return 1;
+  }
+
+  uint32_t nodes = ids.size();
+  auto index = [&ids](uint64_t id) {
+    return static_cast<uint32_t>(std::lower_bound(ids.begin(), ids.end(), id) - ids.begin());
+  };
+
+  // counting sort of both directions of every link into CSR
+  std::vector<uint32_t> offsets(nodes + 1, 0);
+  std::vector<uint32_t> a(from.size()), b(from.size());
+  for (size_t i = 0; i < from.size(); i++) {
+    a[i] = index(from[i]);
+    b[i] = index(to[i]);
+    offsets[a[i] + 1]++;
+    offsets[b[i] + 1]++;
+  }
+  for (uint32_t v = 0; v < nodes; v++)
+    offsets[v + 1] += offsets[v];
+
+  std::vector<uint32_t> targets(offsets[nodes]);
+  std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+  for (size_t i = 0; i < a.size(); i++) {
+    targets[fill[a[i]]++] = b[i];
+    targets[fill[b[i]]++] = a[i];
+  }
+
+  // sort and deduplicate every adjacency, compacting in place
+  uint32_t out = 0;
+  uint32_t begin = 0;
+  for (uint32_t v = 0; v < nodes; v++) {
+    uint32_t end = offsets[v + 1];
+    std::sort(targets.begin() + begin, targets.begin() + end);
+    uint32_t first = out;
+    for (uint32_t i = begin; i < end; i++) {
+      if (out == first || targets[out - 1] != targets[i])
+        targets[out++] = targets[i];
+    }
+    begin = end;
+    offsets[v + 1] = out;
+  }
+  targets.resize(out);
+
+  ns3::ndn::CsrTopologyHeader header;
+  header.Init(nodes, out / 2);
+
+  FILE* file = std::fopen(argv[2], "wb");
+  if (file == nullptr) {
+    std::cerr << "Cannot create " << argv[2] << std::endl;
+    return 1;
+  }
+  bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1
+            && std::fwrite(offsets.data(), sizeof(uint32_t), offsets.size(), file) == offsets.size()
+            && std::fwrite(targets.data(), sizeof(uint32_t), targets.size(), file) == targets.size();
+  ok = std::fclose(file) == 0 && ok;
+  if (!ok) {
+    std::cerr << "Cannot write " << argv[2] << std::endl;
+    return 1;
+  }
+
+  std::cerr << nodes << " nodes, " << header.links << " links" << std::endl;
+  return 0;
+}